@@ -16,13 +16,63 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    appconfig.cpp \
+    batchdecoder.cpp \
+    clockestimator.cpp \
+    compressiondetector.cpp \
+    connectionmanager.cpp \
+    crc32c.cpp \
+    cprmetrics.cpp \
+    decodebenchmark.cpp \
+    devicepipeline.cpp \
+    framedecoder.cpp \
+    frameencoder.cpp \
+    headlessrunner.cpp \
+    ingestionworker.cpp \
+    jitterbuffer.cpp \
+    latencyhistogram.cpp \
+    latencymonitor.cpp \
     main.cpp \
     mainwindow.cpp \
-    qcustomplot.cpp
+    plotbatch.cpp \
+    plotretention.cpp \
+    processingpool.cpp \
+    qcustomplot.cpp \
+    rawinputmodel.cpp \
+    renderscheduler.cpp \
+    replaysource.cpp \
+    sessionrecorder.cpp
 
 HEADERS += \
+    appconfig.h \
+    batchdecoder.h \
+    clockestimator.h \
+    compressiondetector.h \
+    connectionmanager.h \
+    crc32c.h \
+    cprmetrics.h \
+    cprsample.h \
+    decodebenchmark.h \
+    devicepipeline.h \
+    framedecoder.h \
+    frameencoder.h \
+    headlessrunner.h \
+    ingestionworker.h \
+    jitterbuffer.h \
+    latencyhistogram.h \
+    latencymonitor.h \
     mainwindow.h \
-    qcustomplot.h
+    monotonicclock.h \
+    plotbatch.h \
+    plotretention.h \
+    processingpool.h \
+    qcustomplot.h \
+    rawinputmodel.h \
+    renderscheduler.h \
+    replaysource.h \
+    sessionfile.h \
+    sessionrecorder.h \
+    spscqueue.h
 
 FORMS += \
     mainwindow.ui
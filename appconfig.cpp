@@ -0,0 +1,123 @@
+#include "appconfig.h"
+
+#include <QCommandLineParser>
+
+#include <stdio.h>
+#include <string.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Headless mode has to be known before the application object exists
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool isHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0 || strcmp(argv[i], "--bench-decode") == 0
+                || strcmp(argv[i], "--bench-pool") == 0)
+            return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Fill config from the command line; exits on --help or bad options
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void parseCommandLine(const QCoreApplication &app, AppConfig *config)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CPR manikin reader");
+    parser.addHelpOption();
+
+    QCommandLineOption deviceOption("device", "Manikin to connect to, as ip[:port]. May be repeated; the default is 192.168.4.1:9000.", "address");
+    QCommandLineOption countOption("device-count", "Connect to this many devices on consecutive ports, starting at the single --device address.", "count", "1");
+    QCommandLineOption replayOption("replay", "Replay a recorded session instead of connecting to the manikin.", "file");
+    QCommandLineOption speedOption("speed", "Replay speed factor; 0 replays as fast as possible.", "factor", "1");
+    QCommandLineOption threadsOption("threads", "Decoding threads; 0 uses one per core.", "count", "0");
+    QCommandLineOption protocolOption("protocol", "Highest frame protocol version to ask the manikin for; 1 is XOR checked, 2 adds CRC-32C, 3 packs several samples per CRC-32C checked frame with device time and sequence numbers.", "version", QString::number(FrameDecoder::MaxVersion));
+    QCommandLineOption jitterOption("jitter-delay", "Plot this many ms behind, resampled to an even rate, so bursty delivery scrolls smoothly; 0 plots samples as they arrive.", "ms", "0");
+    QCommandLineOption rateOption("display-rate", "Samples per second plotted with --jitter-delay.", "hz", "100");
+    QCommandLineOption fullRedrawOption("full-redraw", "Redraw the whole plot every frame instead of scrolling it; for comparing redraw times.");
+    QCommandLineOption headlessOption("headless", "Record and process without a window.");
+    QCommandLineOption benchOption("bench-decode", "Measure frame decoding throughput and exit.");
+    QCommandLineOption poolOption("bench-pool", "Measure decoding throughput of all devices on 1 to this many pool threads and exit.", "threads");
+    QCommandLineOption recordOption("record", "Headless: record all devices into a session file.", "file");
+    QCommandLineOption durationOption("duration", "Headless: stop after this many seconds.", "seconds", "0");
+    QCommandLineOption statsOption("stats-interval", "Headless: seconds between status lines.", "seconds", "5");
+    parser.addOption(deviceOption);
+    parser.addOption(countOption);
+    parser.addOption(replayOption);
+    parser.addOption(speedOption);
+    parser.addOption(threadsOption);
+    parser.addOption(protocolOption);
+    parser.addOption(jitterOption);
+    parser.addOption(rateOption);
+    parser.addOption(fullRedrawOption);
+    parser.addOption(headlessOption);
+    parser.addOption(benchOption);
+    parser.addOption(poolOption);
+    parser.addOption(recordOption);
+    parser.addOption(durationOption);
+    parser.addOption(statsOption);
+
+    parser.process(app);
+
+    foreach (const QString &value, parser.values(deviceOption)) {
+        DeviceAddress device;
+        int colon = value.lastIndexOf(':');
+        bool ok = true;
+        device.address = QHostAddress(colon < 0 ? value : value.left(colon));
+        device.port = colon < 0 ? 9000 : value.mid(colon + 1).toUShort(&ok);
+        if (device.address.isNull() || !ok) {
+            fprintf(stderr, "Invalid device address: %s\n", qPrintable(value));
+            parser.showHelp(EXIT_FAILURE);
+        }
+        config->devices.append(device);
+    }
+    if (config->devices.isEmpty()) {
+        DeviceAddress device;
+        device.address = QHostAddress("192.168.4.1");
+        device.port = 9000;
+        config->devices.append(device);
+    }
+
+    bool count_ok = false;
+    int count = parser.value(countOption).toInt(&count_ok);
+    if (!count_ok || count < 1 || (count > 1 && config->devices.size() > 1))
+        parser.showHelp(EXIT_FAILURE);
+    if (count > 65536 - config->devices.first().port) {
+        fprintf(stderr, "--device-count %d starting at port %d runs past port 65535\n", count, config->devices.first().port);
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 1; i < count; i++) {
+        DeviceAddress device = config->devices.first();
+        device.port += i;
+        config->devices.append(device);
+    }
+    if (config->devices.size() > AppConfig::MaxDevices) {
+        fprintf(stderr, "At most %d devices are supported\n", AppConfig::MaxDevices);
+        exit(EXIT_FAILURE);
+    }
+
+    config->replay_file = parser.value(replayOption);
+    config->full_redraw = parser.isSet(fullRedrawOption);
+    config->headless = parser.isSet(headlessOption);
+    config->bench_decode = parser.isSet(benchOption);
+    config->record_file = parser.value(recordOption);
+
+    bool speed_ok = false, threads_ok = false, protocol_ok = false, jitter_ok = false, rate_ok = false;
+    bool duration_ok = false, stats_ok = false, pool_ok = true;
+    config->replay_speed = parser.value(speedOption).toDouble(&speed_ok);
+    config->threads = parser.value(threadsOption).toInt(&threads_ok);
+    config->protocol = parser.value(protocolOption).toInt(&protocol_ok);
+    config->jitter_delay = parser.value(jitterOption).toInt(&jitter_ok);
+    config->display_rate = parser.value(rateOption).toDouble(&rate_ok);
+    config->duration = parser.value(durationOption).toInt(&duration_ok);
+    config->stats_interval = parser.value(statsOption).toInt(&stats_ok);
+    if (parser.isSet(poolOption))
+        config->bench_pool = parser.value(poolOption).toInt(&pool_ok);
+    if (!speed_ok || config->replay_speed < 0.0 || !threads_ok || config->threads < 0
+            || !protocol_ok || config->protocol < 1 || config->protocol > FrameDecoder::MaxVersion
+            || !jitter_ok || config->jitter_delay < 0 || !rate_ok || config->display_rate < 1.0
+            || !duration_ok || config->duration < 0 || !stats_ok || config->stats_interval < 1
+            || !pool_ok || config->bench_pool < 0)
+        parser.showHelp(EXIT_FAILURE);
+}
@@ -0,0 +1,42 @@
+#ifndef APPCONFIG_H
+#define APPCONFIG_H
+
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+
+#include "framedecoder.h"
+
+// Where one manikin is reached
+struct DeviceAddress {
+    QHostAddress address;
+    quint16 port;
+};
+
+// Settings taken from the command line
+struct AppConfig {
+    static const int MaxDevices = 16;
+
+    QList<DeviceAddress> devices;   // 1..MaxDevices after parseCommandLine()
+
+    QString replay_file;            // replay a recorded session instead of connecting
+    double replay_speed = 1.0;      // 0 replays as fast as possible
+    int threads = 0;                // processing pool threads, 0 is one per core
+    int protocol = FrameDecoder::MaxVersion;    // highest frame protocol version to negotiate
+    int jitter_delay = 0;           // ms the live plot lags behind to scroll evenly, 0 plots samples as they arrive
+    double display_rate = 100.0;    // samples per second plotted with a jitter delay
+    bool full_redraw = false;       // replot the whole window every frame, to compare with the strip redraw
+
+    bool headless = false;          // no widgets, see HeadlessRunner
+    bool bench_decode = false;      // only run the decoder benchmark
+    int bench_pool = 0;             // only run the pool benchmark, with 1..bench_pool threads
+    QString record_file;            // headless: record every device into this session file
+    int duration = 0;               // headless: seconds to run, 0 runs until interrupted
+    int stats_interval = 5;         // headless: seconds between status lines
+};
+
+bool isHeadless(int argc, char *argv[]);
+void parseCommandLine(const QCoreApplication &app, AppConfig *config);
+
+#endif // APPCONFIG_H
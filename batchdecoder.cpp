@@ -0,0 +1,232 @@
+#include "batchdecoder.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATCHDECODER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Plain C++ - the same arithmetic as FrameDecoder::decodePayload()
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void decodeScalar(const uint8_t *payloads, int first, int count, BatchDecoder::Output *out)
+{
+    for (int i = first; i < count; i++) {
+        const uint8_t *payload = payloads + i * FrameDecoder::PayloadSize;
+        int16_t x = (int16_t)(payload[0] | (payload[1] << 8));
+        int16_t y = (int16_t)(payload[2] | (payload[3] << 8));
+        int16_t z = (int16_t)(payload[4] | (payload[5] << 8));
+        uint16_t displacement_raw = (uint16_t)(payload[6] | (payload[7] << 8));
+        int16_t velocity_raw = (int16_t)(payload[8] | (payload[9] << 8));
+
+        float acl_x = ((float)x / 1.0e4);
+        float acl_y = ((float)y / 1.0e4);
+        float acl_z = ((float)z / 1.0e4);
+        out->acl_x[i] = acl_x;
+        out->acl_y[i] = acl_y;
+        out->acl_z[i] = acl_z;
+        out->acl_len[i] = sqrt((acl_x * acl_x) + (acl_y * acl_y) + (acl_z * acl_z));
+        out->displacement[i] = (float)((float)displacement_raw / 1.0e4);
+        out->velocity[i] = (float)((float)velocity_raw / 1.0e4);
+        out->tap_count[i] = payload[10];
+        out->cpr_good[i] = payload[11] != 0;
+    }
+}
+
+#ifdef BATCHDECODER_X86
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Load 8 payloads and transpose them so that row n holds the n-th int16
+// field of every frame: x, y, z, displacement, velocity, tap|cpr
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static inline void loadFields(const uint8_t *payloads, __m128i *rows)
+{
+    __m128i a[8];
+    for (int k = 0; k < 8; k++)         // 16 byte loads, the last 4 bytes are never used
+        a[k] = _mm_loadu_si128((const __m128i *)(payloads + k * FrameDecoder::PayloadSize));
+
+    __m128i t0 = _mm_unpacklo_epi16(a[0], a[1]);
+    __m128i t1 = _mm_unpackhi_epi16(a[0], a[1]);
+    __m128i t2 = _mm_unpacklo_epi16(a[2], a[3]);
+    __m128i t3 = _mm_unpackhi_epi16(a[2], a[3]);
+    __m128i t4 = _mm_unpacklo_epi16(a[4], a[5]);
+    __m128i t5 = _mm_unpackhi_epi16(a[4], a[5]);
+    __m128i t6 = _mm_unpacklo_epi16(a[6], a[7]);
+    __m128i t7 = _mm_unpackhi_epi16(a[6], a[7]);
+
+    __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+    __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+    __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+    __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+    __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+    __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+
+    rows[0] = _mm_unpacklo_epi64(u0, u4);
+    rows[1] = _mm_unpackhi_epi64(u0, u4);
+    rows[2] = _mm_unpacklo_epi64(u1, u5);
+    rows[3] = _mm_unpackhi_epi64(u1, u5);
+    rows[4] = _mm_unpacklo_epi64(u2, u6);
+    rows[5] = _mm_unpackhi_epi64(u2, u6);
+}
+
+// tap count is the low byte of the last row, cpr good the high byte
+static inline void storeFlags(__m128i row, uint8_t *tap_count, uint8_t *cpr_good)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i tap = _mm_and_si128(row, _mm_set1_epi16(0x00FF));
+    __m128i good = _mm_min_epi16(_mm_srli_epi16(row, 8), _mm_set1_epi16(1));
+    _mm_storel_epi64((__m128i *)tap_count, _mm_packus_epi16(tap, zero));
+    _mm_storel_epi64((__m128i *)cpr_good, _mm_packus_epi16(good, zero));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// SSE2, 4 lanes per conversion
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static inline __m128 signedLo(__m128i row) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(row, row), 16)); }
+static inline __m128 signedHi(__m128i row) { return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(row, row), 16)); }
+static inline __m128 unsignedLo(__m128i row) { return _mm_cvtepi32_ps(_mm_unpacklo_epi16(row, _mm_setzero_si128())); }
+static inline __m128 unsignedHi(__m128i row) { return _mm_cvtepi32_ps(_mm_unpackhi_epi16(row, _mm_setzero_si128())); }
+
+static void storeSse2(const __m128 *raw, int i, BatchDecoder::Output *out)
+{
+    // divide, not multiply by 1e-4 - a multiplication would round differently from the scalar path
+    const __m128 scale = _mm_set1_ps(1.0e4f);
+    __m128 x = _mm_div_ps(raw[0], scale);
+    __m128 y = _mm_div_ps(raw[1], scale);
+    __m128 z = _mm_div_ps(raw[2], scale);
+    __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+
+    _mm_storeu_ps(out->acl_x + i, x);
+    _mm_storeu_ps(out->acl_y + i, y);
+    _mm_storeu_ps(out->acl_z + i, z);
+    _mm_storeu_ps(out->acl_len + i, len);
+    _mm_storeu_ps(out->displacement + i, _mm_div_ps(raw[3], scale));
+    _mm_storeu_ps(out->velocity + i, _mm_div_ps(raw[4], scale));
+}
+
+static int decodeSse2(const uint8_t *payloads, int count, BatchDecoder::Output *out)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i rows[6];
+        loadFields(payloads + i * FrameDecoder::PayloadSize, rows);
+
+        __m128 lo[5] = { signedLo(rows[0]), signedLo(rows[1]), signedLo(rows[2]), unsignedLo(rows[3]), signedLo(rows[4]) };
+        __m128 hi[5] = { signedHi(rows[0]), signedHi(rows[1]), signedHi(rows[2]), unsignedHi(rows[3]), signedHi(rows[4]) };
+        storeSse2(lo, i, out);
+        storeSse2(hi, i + 4, out);
+        storeFlags(rows[5], out->tap_count + i, out->cpr_good + i);
+    }
+    return i;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// AVX2, all 8 frames of a group per conversion. Built with only the avx2
+// target so the compiler cannot contract mul+add into an FMA, which
+// would round differently from the scalar path
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+AVX2_TARGET static int decodeAvx2(const uint8_t *payloads, int count, BatchDecoder::Output *out)
+{
+    const __m256 scale = _mm256_set1_ps(1.0e4f);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i rows[6];
+        loadFields(payloads + i * FrameDecoder::PayloadSize, rows);
+
+        __m256 x = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(rows[0])), scale);
+        __m256 y = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(rows[1])), scale);
+        __m256 z = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(rows[2])), scale);
+        __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+
+        _mm256_storeu_ps(out->acl_x + i, x);
+        _mm256_storeu_ps(out->acl_y + i, y);
+        _mm256_storeu_ps(out->acl_z + i, z);
+        _mm256_storeu_ps(out->acl_len + i, len);
+        _mm256_storeu_ps(out->displacement + i, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(rows[3])), scale));
+        _mm256_storeu_ps(out->velocity + i, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(rows[4])), scale));
+        storeFlags(rows[5], out->tap_count + i, out->cpr_good + i);
+    }
+    return i;
+}
+
+static bool cpuHasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)     // the OS has to save the ymm registers
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // BATCHDECODER_X86
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Convert count (at most MaxBatch) payloads; the vector kernels handle
+// groups of 8 and leave the rest to the scalar loop
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void BatchDecoder::decode(const uint8_t *payloads, int count, Output *out, Kernel kernel)
+{
+    static const bool avx2 = isSupported(Avx2);
+
+    if (kernel == Best)
+        kernel = avx2 ? Avx2 : (isSupported(Sse2) ? Sse2 : Scalar);
+
+    int done = 0;
+#ifdef BATCHDECODER_X86
+    if (kernel == Avx2)
+        done = decodeAvx2(payloads, count, out);
+    else if (kernel == Sse2)
+        done = decodeSse2(payloads, count, out);
+#endif
+    decodeScalar(payloads, done, count, out);
+}
+
+bool BatchDecoder::isSupported(Kernel kernel)
+{
+    switch (kernel) {
+#ifdef BATCHDECODER_X86
+        case Sse2:
+            return true;                // part of x86-64
+        case Avx2:
+            return cpuHasAvx2();
+#else
+        case Sse2:
+        case Avx2:
+            return false;
+#endif
+        default:
+            return true;
+    }
+}
+
+const char *BatchDecoder::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+        case Scalar:
+            return "scalar";
+        case Sse2:
+            return "SSE2";
+        case Avx2:
+            return "AVX2";
+        default:
+            return isSupported(Avx2) ? "AVX2" : (isSupported(Sse2) ? "SSE2" : "scalar");
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef BATCHDECODER_H
+#define BATCHDECODER_H
+
+#include <stdint.h>
+
+#include "framedecoder.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Converts a run of validated frames into physical units at once.
+//
+// Input is what FrameDecoder::nextPayloads() produces: count payloads of
+// FrameDecoder::PayloadSize bytes back to back, whatever protocol version
+// they came in, followed by at least InputPadding readable bytes (the
+// vector kernels load 16 bytes per payload). Output is structure-of-arrays, one float array per plotted
+// quantity, which is also how the graphs take their data.
+//
+// decode() picks the widest kernel the CPU supports at run time: AVX2,
+// SSE2, or plain C++ on other architectures. All of them give bit-for-bit
+// the results of FrameDecoder::decodeNext().
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class BatchDecoder
+{
+public:
+    static const int MaxBatch = 256;
+    static const int InputPadding = 16;
+
+    struct Output {
+        float acl_x[MaxBatch];
+        float acl_y[MaxBatch];
+        float acl_z[MaxBatch];
+        float acl_len[MaxBatch];
+        float displacement[MaxBatch];
+        float velocity[MaxBatch];
+        uint8_t tap_count[MaxBatch];
+        uint8_t cpr_good[MaxBatch];
+    };
+
+    enum Kernel {
+        Scalar,
+        Sse2,
+        Avx2,
+        Best                        // what decode() uses
+    };
+
+    static void decode(const uint8_t *payloads, int count, Output *out, Kernel kernel = Best);
+    static bool isSupported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+};
+
+#endif // BATCHDECODER_H
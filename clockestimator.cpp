@@ -0,0 +1,112 @@
+#include "clockestimator.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Unwrap a 32 bit device tick (us) to nanoseconds since the first one
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int64_t ClockEstimator::deviceTime(uint32_t tick)
+{
+    if (started) {
+        int32_t delta = (int32_t)(tick - last_tick);    // wraps every ~71 minutes
+        if (delta < -RestartJump)
+            reset();                                    // device restarted, its clock with it
+        else
+            device_us += delta;
+    }
+    if (!started) {
+        started = true;
+        device_us = 0;
+    }
+    last_tick = tick;
+    return device_us * 1000;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Take a sample's device time and when it arrived, both in ns
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ClockEstimator::addObservation(int64_t device_time, int64_t host_time)
+{
+    int64_t difference = host_time - device_time;
+
+    if (in_window && device_time - window_start >= Window) {
+        int slot = (window_first + window_count) % MaxWindows;
+        if (window_count == MaxWindows)
+            window_first = (window_first + 1) % MaxWindows;
+        else
+            window_count++;
+        devices[slot] = window_device;
+        offsets[slot] = window_offset;
+        in_window = false;
+        fit();
+    }
+    if (!in_window) {
+        in_window = true;
+        window_start = device_time;
+        window_device = device_time;
+        window_offset = difference;
+    } else if (difference < window_offset) {
+        window_device = device_time;
+        window_offset = difference;
+    }
+    if (!isValid() && (window_count == 0 || window_offset < offset)) {
+        origin = window_device;
+        offset = (double)window_offset;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Least squares line through the window minima
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ClockEstimator::fit()
+{
+    if (window_count == 1) {
+        origin = devices[window_first];
+        offset = (double)offsets[window_first];
+        return;
+    }
+
+    // relative to the oldest window so the sums keep their precision
+    int64_t x0 = devices[window_first];
+    int64_t y0 = offsets[window_first];
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    for (int i = 0; i < window_count; i++) {
+        int slot = (window_first + i) % MaxWindows;
+        double x = (double)(devices[slot] - x0);
+        double y = (double)(offsets[slot] - y0);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    double n = window_count;
+    double denominator = n * sxx - sx * sx;
+    if (denominator <= 0.0)
+        return;
+    skew = (n * sxy - sx * sy) / denominator;
+    origin = x0;
+    offset = y0 + (sy - skew * sx) / n;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Host time (ns) at which the device clock read device_time
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int64_t ClockEstimator::toHost(int64_t device_time) const
+{
+    if (!isValid())
+        return device_time + (int64_t)offset;
+    return device_time + (int64_t)(offset + skew * (double)(device_time - origin));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Forget the device clock, e.g. after the connection dropped
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ClockEstimator::reset()
+{
+    started = false;
+    device_us = 0;
+    in_window = false;
+    window_first = 0;
+    window_count = 0;
+    origin = 0;
+    offset = 0.0;
+    skew = 0.0;
+}
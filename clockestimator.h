@@ -0,0 +1,61 @@
+#ifndef CLOCKESTIMATOR_H
+#define CLOCKESTIMATOR_H
+
+#include <stdint.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Maps a device's sample clock onto the host's monotonic clock.
+//
+// v3 frames carry a free running 32 bit microsecond tick. deviceTime()
+// unwraps it to 64 bit nanoseconds; a jump back by more than RestartJump
+// is taken as a device restart and starts the estimate over.
+//
+// Every sample is an observation host - device = offset + network delay.
+// The delay is never negative and usually close to its minimum, so only
+// the smallest difference of each Window of device time is kept, and a
+// least squares line through the last MaxWindows of them gives offset and
+// skew. Until two windows are complete toHost() uses the smallest
+// difference seen so far. Timestamps taken from it follow the device's
+// sampling, not the arrival jitter of the network and reader thread.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class ClockEstimator
+{
+public:
+    static const int64_t Window = 1000000000;      // ns
+    static const int MaxWindows = 64;
+    static const int64_t RestartJump = 1000000;     // us
+
+    int64_t deviceTime(uint32_t tick);
+    void addObservation(int64_t device_time, int64_t host_time);
+    int64_t toHost(int64_t device_time) const;
+    void reset();
+
+    bool isValid() const { return window_count >= 2; }
+    double skewPpm() const { return isValid() ? skew * 1.0e6 : 0.0; }
+
+private:
+    void fit();
+
+    bool started = false;
+    uint32_t last_tick = 0;
+    int64_t device_us = 0;
+
+    // the window being filled
+    bool in_window = false;
+    int64_t window_start = 0;
+    int64_t window_device = 0;
+    int64_t window_offset = 0;
+
+    // smallest host - device of the last complete windows, oldest first at window_first
+    int64_t devices[MaxWindows];
+    int64_t offsets[MaxWindows];
+    int window_first = 0;
+    int window_count = 0;
+
+    // host = device + offset + skew * (device - origin)
+    int64_t origin = 0;
+    double offset = 0.0;
+    double skew = 0.0;
+};
+
+#endif // CLOCKESTIMATOR_H
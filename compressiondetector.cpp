@@ -0,0 +1,103 @@
+#include "compressiondetector.h"
+
+static const float Hysteresis = 0.005f;    // m, ignores sensor noise around bottoms and tops
+static const float MinDepth = 0.050f;
+static const float MaxDepth = 0.060f;
+static const float MaxRecoil = 0.005f;     // m left at the top for a full recoil
+static const float MinRate = 100.0f;       // per minute
+static const float MaxRate = 120.0f;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Follow the displacement down to each bottom and back up to each top
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool CompressionDetector::addSample(int64_t timestamp, float displacement)
+{
+    if (!(displacement == displacement))    // NaN
+        return false;
+
+    if (!started) {
+        started = true;
+        pushing = true;
+        start_time = extreme_time = timestamp;
+        start_top = extreme = displacement;
+        return false;
+    }
+
+    if (pushing) {
+        if (displacement > extreme) {
+            extreme = displacement;
+            extreme_time = timestamp;
+        } else if (displacement < extreme - Hysteresis) {
+            bottom = extreme;               // passed the bottom, now recoiling
+            bottom_time = extreme_time;
+            pushing = false;
+            extreme = displacement;
+            extreme_time = timestamp;
+        } else if (extreme - start_top < Hysteresis && displacement < start_top) {
+            start_top = extreme = displacement;     // still settling at the top
+            start_time = extreme_time = timestamp;
+        }
+        return false;
+    }
+
+    if (displacement < extreme) {
+        extreme = displacement;
+        extreme_time = timestamp;
+        return false;
+    }
+    if (displacement > extreme + Hysteresis || timestamp - extreme_time >= RecoilTimeout) {
+        finish(extreme_time, extreme);      // passed the top or stopped there, the next one starts from it
+        pushing = true;
+        start_time = extreme_time;
+        start_top = extreme;
+        extreme = displacement;
+        extreme_time = timestamp;
+        return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Measure and score the compression that just ended at top
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void CompressionDetector::finish(int64_t top_time, float top)
+{
+    Compression &c = last_compression;
+    int64_t cycle = top_time - start_time;
+
+    c.bottom_time = bottom_time;
+    c.depth = bottom;
+    c.recoil = top > 0.0f ? top : 0.0f;
+    c.duty_cycle = cycle > 0 ? (float)(bottom_time - start_time) / (float)cycle : 0.5f;
+    c.rate = 0.0f;
+    bool timed = previous_bottom && bottom_time - previous_bottom <= PauseTime && bottom_time > previous_bottom;
+    if (timed)
+        c.rate = 60.0e9f / (float)(bottom_time - previous_bottom);
+    previous_bottom = bottom_time;
+
+    c.depth_ok = c.depth >= MinDepth && c.depth <= MaxDepth;
+    c.rate_ok = !timed || (c.rate >= MinRate && c.rate <= MaxRate);    // nothing to judge the first one by
+    c.recoil_ok = c.recoil <= MaxRecoil;
+    compressions++;
+
+    uint8_t flags = (c.depth_ok ? 1 : 0) | (c.rate_ok ? 2 : 0) | (c.recoil_ok ? 4 : 0);
+    if (check_count == ScoreWindow) {
+        uint8_t old = checks[check_next];
+        passed -= (old & 1) + ((old >> 1) & 1) + ((old >> 2) & 1);
+    } else {
+        check_count++;
+    }
+    checks[check_next] = flags;
+    check_next = (check_next + 1) % ScoreWindow;
+    passed += (flags & 1) + ((flags >> 1) & 1) + ((flags >> 2) & 1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Percentage of checks passed over the last ScoreWindow compressions
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int CompressionDetector::score() const
+{
+    if (check_count == 0)
+        return -1;
+    return (passed * 100 + check_count * 3 / 2) / (check_count * 3);
+}
@@ -0,0 +1,74 @@
+#ifndef COMPRESSIONDETECTOR_H
+#define COMPRESSIONDETECTOR_H
+
+#include <stdint.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Finds individual chest compressions in the displacement stream and
+// scores them against the resuscitation guidelines.
+//
+// Displacement is in meters from the rest position, growing with depth.
+// A compression bottoms out once displacement comes back 5 mm above its
+// deepest point, and ends once it goes 5 mm down again from the highest
+// point of the release that follows. Each one gives its depth (from
+// rest), the recoil left at its end, its duty cycle (time going down over
+// the whole cycle) and the rate from the previous bottom. The last one
+// before the rescuer stops never sees that next push, so it also ends
+// once the release has not gone any higher for RecoilTimeout.
+//
+// The score is the share of depth (50-60 mm), rate (100-120 per minute)
+// and full recoil (within 5 mm of rest) checks passed by the last
+// ScoreWindow compressions, kept as running counts so every sample
+// costs a few comparisons. The first compression after a start or a
+// pause has no rate and passes the rate check.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class CompressionDetector
+{
+public:
+    static const int64_t PauseTime = 2000000000;   // ns without a compression before the rate drops to 0
+    static const int64_t RecoilTimeout = 500000000; // ns at the top of a release before it counts as ended
+    static const int ScoreWindow = 30;
+
+    struct Compression {
+        int64_t bottom_time;        // ns
+        float depth;                // m, deepest displacement
+        float recoil;               // m short of the rest position at the end
+        float duty_cycle;           // 0..1
+        float rate;                 // per minute, 0 for the first one after a pause
+        bool depth_ok;
+        bool rate_ok;
+        bool recoil_ok;
+    };
+
+    // true when the sample completed a compression, see last()
+    bool addSample(int64_t timestamp, float displacement);
+
+    const Compression &last() const { return last_compression; }
+    uint64_t compressionCount() const { return compressions; }
+    bool isPaused(int64_t now) const { return compressions == 0 || now - last_compression.bottom_time > PauseTime; }
+    int score() const;              // 0..100, -1 before the first compression
+
+private:
+    void finish(int64_t top_time, float top);
+
+    bool pushing = true;            // going down towards a bottom, else recoiling
+    int64_t start_time = 0;         // the top this compression started from
+    float start_top = 0.0f;
+    bool started = false;
+    int64_t extreme_time = 0;       // deepest point going down, highest coming up
+    float extreme = 0.0f;
+    int64_t bottom_time = 0;
+    float bottom = 0.0f;
+    int64_t previous_bottom = 0;    // 0 if none recent enough to give a rate
+
+    Compression last_compression = Compression();
+    uint64_t compressions = 0;
+
+    // pass flags of the last ScoreWindow compressions, bit 0 depth, 1 rate, 2 recoil
+    uint8_t checks[ScoreWindow] = {};
+    int check_next = 0;
+    int check_count = 0;
+    int passed = 0;
+};
+
+#endif // COMPRESSIONDETECTOR_H
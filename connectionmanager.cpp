@@ -0,0 +1,168 @@
+#include "connectionmanager.h"
+#include "monotonicclock.h"
+
+#include <QRandomGenerator>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+ConnectionManager::ConnectionManager(const QHostAddress &address, quint16 port, QObject *parent) :
+    QObject(parent),
+    address(address),
+    port(port),
+    retry_timer(this),      // parented so they follow moveToThread()
+    watchdog(this)
+{
+    down_since = monotonicNanoseconds();
+
+    retry_timer.setSingleShot(true);
+    connect(&retry_timer, &QTimer::timeout, this, &ConnectionManager::attempt);
+    connect(&watchdog, &QTimer::timeout, this, &ConnectionManager::checkTimeouts);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Start connecting; returns at once
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ConnectionManager::open()
+{
+    if (!tcp) {
+        tcp = new QTcpSocket(this);     // created here so it belongs to the owner's thread
+        connect(tcp, &QTcpSocket::connected, this, &ConnectionManager::socketConnected);
+        connect(tcp, &QTcpSocket::stateChanged, this, &ConnectionManager::socketStateChanged);
+        connect(tcp, &QTcpSocket::readyRead, this, &ConnectionManager::socketReadyRead);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        connect(tcp, &QAbstractSocket::errorOccurred, this, &ConnectionManager::forwardError);
+#else
+        connect(tcp, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::error), this, &ConnectionManager::forwardError);
+#endif
+    }
+
+    // the outage counts from here, not from construction or an earlier close()
+    if (!link_up)
+        down_since.store(monotonicNanoseconds(), std::memory_order_relaxed);
+
+    stopped = false;
+    backoff = InitialBackoff;
+    watchdog.start(250);
+    attempt();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Drop the connection and stop retrying
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ConnectionManager::close()
+{
+    stopped = true;
+    retry_timer.stop();
+    watchdog.stop();
+    if (tcp)
+        tcp->abort();
+}
+
+uint64_t ConnectionManager::reconnects() const
+{
+    uint64_t count = connects.load(std::memory_order_relaxed);
+    return count > 0 ? count - 1 : 0;
+}
+
+int64_t ConnectionManager::downtime(int64_t now) const
+{
+    int64_t since = down_since.load(std::memory_order_relaxed);
+    return total_downtime.load(std::memory_order_relaxed) + (since ? now - since : 0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// One asynchronous connect; success or failure arrive as socket signals
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ConnectionManager::attempt()
+{
+    if (stopped)
+        return;
+    attempts.fetch_add(1, std::memory_order_relaxed);
+    attempt_started = monotonicNanoseconds();
+    tcp->connectToHost(address, port);
+}
+
+void ConnectionManager::socketConnected()
+{
+    int64_t now = monotonicNanoseconds();
+
+    tcp->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    tcp->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+
+    last_connect_time.store(now - attempt_started, std::memory_order_relaxed);
+    total_downtime.fetch_add(now - down_since.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    down_since.store(0, std::memory_order_relaxed);
+    connects.fetch_add(1, std::memory_order_relaxed);
+
+    link_up = true;
+    last_read = now;
+    backoff = InitialBackoff;
+    emit connected();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Every way of losing the link - failed connect, abort, remote close -
+// ends in UnconnectedState, so retries are scheduled from here only
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ConnectionManager::socketStateChanged(QAbstractSocket::SocketState state)
+{
+    if (state != QAbstractSocket::UnconnectedState)
+        return;
+
+    if (link_up) {
+        link_up = false;
+        down_since.store(monotonicNanoseconds(), std::memory_order_relaxed);
+        emit disconnected();
+    }
+    if (!stopped)
+        scheduleRetry();
+}
+
+void ConnectionManager::socketReadyRead()
+{
+    last_read = monotonicNanoseconds();
+    emit readyRead();
+}
+
+void ConnectionManager::forwardError(QAbstractSocket::SocketError error)
+{
+    emit socketError(error, tcp->errorString());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Abort connects that hang and links that went silent; the abort ends
+// in socketStateChanged() which schedules the retry
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ConnectionManager::checkTimeouts()
+{
+    int64_t now = monotonicNanoseconds();
+    QAbstractSocket::SocketState state = tcp->state();
+
+    if ((state == QAbstractSocket::HostLookupState || state == QAbstractSocket::ConnectingState)
+        && now - attempt_started > ConnectTimeout * 1000000LL) {
+        emit socketError(QAbstractSocket::SocketTimeoutError, "Connection timed out");
+        tcp->abort();
+    } else if (state == QAbstractSocket::ConnectedState && now - last_read > IdleTimeout * 1000000LL) {
+        emit socketError(QAbstractSocket::SocketTimeoutError, "No data received");
+        tcp->abort();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Next attempt after the current backoff, then double it
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ConnectionManager::scheduleRetry()
+{
+    if (retry_timer.isActive())
+        return;
+
+    // jitter keeps a room full of clients from reconnecting in lockstep after an access point reboot
+    int delay = backoff * (80 + QRandomGenerator::global()->bounded(41)) / 100;
+    retry_timer.start(delay);
+    emit retryScheduled(delay);
+
+    backoff *= 2;
+    if (backoff > MaxBackoff)
+        backoff = MaxBackoff;
+}
@@ -0,0 +1,86 @@
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+
+#include <QObject>
+#include <QAbstractSocket>
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <atomic>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Keeps a TCP connection to one manikin up.
+//
+// Connecting never blocks: open() starts an asynchronous connect and
+// returns. Whenever the link goes down - refused, timed out, closed by the
+// peer or silent for longer than IdleTimeout - the next attempt is
+// scheduled with exponential backoff (InitialBackoff doubling up to
+// MaxBackoff, +-20% jitter) until close() is called.
+//
+// Lives in the thread of its owner (see IngestionWorker); the link
+// statistics can be read from any thread.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class ConnectionManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int InitialBackoff = 250;      // ms
+    static const int MaxBackoff = 10000;        // ms
+    static const int ConnectTimeout = 5000;     // ms, per attempt
+    static const int IdleTimeout = 3000;        // ms without data before the link counts as dead
+
+    ConnectionManager(const QHostAddress &address, quint16 port, QObject *parent = nullptr);
+
+    void open();
+    void close();
+
+    // Only valid between open() and close(), in the owner's thread
+    QTcpSocket *socket() const { return tcp; }
+
+    // Safe to call from any thread
+    bool isConnected() const { return down_since.load(std::memory_order_relaxed) == 0; }
+    uint64_t connectAttempts() const { return attempts.load(std::memory_order_relaxed); }
+    uint64_t reconnects() const;
+    int64_t lastConnectTime() const { return last_connect_time.load(std::memory_order_relaxed); }   // ns
+    int64_t downtime(int64_t now) const;                                                            // ns, including the current outage
+
+signals:
+    void connected();
+    void disconnected();
+    void readyRead();
+    void socketError(QAbstractSocket::SocketError error, const QString &errorString);
+    void retryScheduled(int delay);
+
+private slots:
+    void attempt();
+    void socketConnected();
+    void socketStateChanged(QAbstractSocket::SocketState state);
+    void socketReadyRead();
+    void forwardError(QAbstractSocket::SocketError error);
+    void checkTimeouts();
+
+private:
+    void scheduleRetry();
+
+    QHostAddress address;
+    quint16 port;
+
+    QTcpSocket* tcp = nullptr;
+    QTimer retry_timer;
+    QTimer watchdog;
+    bool stopped = true;
+    bool link_up = false;
+    int backoff = InitialBackoff;
+    int64_t attempt_started = 0;
+    int64_t last_read = 0;
+
+    std::atomic<uint64_t> attempts{0};
+    std::atomic<uint64_t> connects{0};
+    std::atomic<int64_t> last_connect_time{0};
+    std::atomic<int64_t> total_downtime{0};
+    std::atomic<int64_t> down_since{0};     // 0 while connected
+};
+
+#endif // CONNECTIONMANAGER_H
@@ -0,0 +1,28 @@
+#include "cprmetrics.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Take the device's latest tap count and CPR quality flag
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void CprMetrics::addSample(const CprSample &sample)
+{
+    tap_count = sample.tap_count;
+    cpr_good = sample.cpr_good;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Advance to key (seconds); true when a new taps/minute estimate is ready
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool CprMetrics::update(double key)
+{
+    if (key - per_second_key >= 1) {    // how many taps we made for this second
+        inner_tap_count = inner_tap_count + tap_count;
+        per_second_key = key;
+    }
+    if (key - per_minute_key > 15) {    // every 15 seconds we can estimate taps per minute
+        taps_per_minute = inner_tap_count * 4;
+        inner_tap_count = 0;
+        per_minute_key = key;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,34 @@
+#ifndef CPRMETRICS_H
+#define CPRMETRICS_H
+
+#include <stdint.h>
+
+#include "cprsample.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Tap rate estimation shared by the GUI and the headless mode.
+//
+// The latest tap count is summed once per second and scaled to taps per
+// minute every 15 seconds.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class CprMetrics
+{
+public:
+    void addSample(const CprSample &sample);
+    bool update(double key);
+
+    uint8_t tapsPerSecond() const { return tap_count; }
+    int tapsPerMinute() const { return taps_per_minute; }
+    bool cprGood() const { return cpr_good; }
+
+private:
+    uint8_t tap_count = 0;
+    bool cpr_good = false;
+    int inner_tap_count = 0;
+    int taps_per_minute = 0;
+
+    double per_second_key = 0.0;
+    double per_minute_key = 0.0;
+};
+
+#endif // CPRMETRICS_H
@@ -0,0 +1,25 @@
+#ifndef CPRSAMPLE_H
+#define CPRSAMPLE_H
+
+#include <stdint.h>
+
+// One decoded accelerometer/compression sample as sent by the manikin
+typedef struct {
+    int64_t timestamp;      // monotonicNanoseconds() when taken (v3 device tick) or read from the socket
+    float acl_x;
+    float acl_y;
+    float acl_z;
+    float acl_len;          // accelerometer vector length
+    float displacement;
+    float velocity;
+    uint8_t tap_count;
+    bool cpr_good;
+    bool gap;               // marker for lost data: all values NaN, breaks the plotted lines
+
+    // latency stamps, monotonicNanoseconds()
+    int64_t read_at;
+    int64_t decoded_at;
+    int64_t enqueued_at;
+} CprSample;
+
+#endif // CPRSAMPLE_H
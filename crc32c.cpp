@@ -0,0 +1,111 @@
+#include "crc32c.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SSE42_TARGET
+#else
+#define SSE42_TARGET __attribute__((target("sse4.2")))
+#endif
+#endif
+
+static const uint32_t Polynomial = 0x82F63B78;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// table[0] is the classic byte table, table[k] advances a byte by k more
+// zero bytes; built once on first use
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    Crc32cTables()
+    {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc >> 1) ^ (Polynomial & (0u - (crc & 1)));
+            table[0][i] = crc;
+        }
+        for (int k = 1; k < 8; k++) {
+            for (int i = 0; i < 256; i++)
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+        }
+    }
+};
+
+static uint32_t crc32cTables(const uint8_t *data, int len)
+{
+    static const Crc32cTables tables;
+    const uint32_t (*t)[256] = tables.table;
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+        uint32_t hi = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        data += 8;
+        len -= 8;
+    }
+    while (len-- > 0)
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+
+    return crc ^ 0xFFFFFFFF;
+}
+
+#ifdef CRC32C_X86
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// SSE4.2 has an instruction for exactly this polynomial, 8 bytes at a time
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+SSE42_TARGET static uint32_t crc32cSse42(const uint8_t *data, int len)
+{
+    uint64_t crc = 0xFFFFFFFF;
+
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, data, 8);
+        crc = _mm_crc32_u64(crc, word);
+        data += 8;
+        len -= 8;
+    }
+    uint32_t crc32 = (uint32_t)crc;
+    if (len >= 4) {
+        uint32_t word;
+        memcpy(&word, data, 4);
+        crc32 = _mm_crc32_u32(crc32, word);
+        data += 4;
+        len -= 4;
+    }
+    while (len-- > 0)
+        crc32 = _mm_crc32_u8(crc32, *data++);
+
+    return crc32 ^ 0xFFFFFFFF;
+}
+
+static bool cpuHasSse42()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+#endif // CRC32C_X86
+
+uint32_t crc32c(const uint8_t *data, int len)
+{
+#ifdef CRC32C_X86
+    static const bool sse42 = cpuHasSse42();
+    if (sse42)
+        return crc32cSse42(data, len);
+#endif
+    return crc32cTables(data, len);
+}
@@ -0,0 +1,273 @@
+#include "decodebenchmark.h"
+#include "appconfig.h"
+#include "batchdecoder.h"
+#include "compressiondetector.h"
+#include "devicepipeline.h"
+#include "framedecoder.h"
+#include "frameencoder.h"
+#include "monotonicclock.h"
+#include "processingpool.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static const int StreamSamples = 1 << 16;
+static const int Rounds = 64;
+static const int PoolRounds = 8;        // per device, AppConfig::MaxDevices of them
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// A plausible stream: random accelerometer noise, some taps; v3 packs
+// the most samples per frame
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static std::vector<uint8_t> makeStream(int version)
+{
+    std::vector<uint8_t> stream(StreamSamples * FrameDecoder::V2WireFrameSize);
+    RawSample batch[FrameDecoder::MaxSamplesPerFrame];
+    size_t size = 0;
+    srand(1);
+    for (int i = 0; i < StreamSamples; i++) {
+        RawSample &raw = batch[i % FrameDecoder::MaxSamplesPerFrame];
+        raw.x = (int16_t)(rand() % 20001 - 10000);
+        raw.y = (int16_t)(rand() % 20001 - 10000);
+        raw.z = (int16_t)(rand() % 20001 - 10000);
+        raw.displacement = (uint16_t)(rand() % 600);
+        raw.velocity = (int16_t)(rand() % 4001 - 2000);
+        raw.tap_count = (uint8_t)(i % 50 == 0);
+        raw.cpr_good = (uint8_t)(i % 3 != 0);
+        if (version < 3)
+            size += FrameEncoder::encode(raw, stream.data() + size, version);
+        else if ((i + 1) % FrameDecoder::MaxSamplesPerFrame == 0)
+            size += FrameEncoder::encodeBatch(batch, FrameDecoder::MaxSamplesPerFrame, (uint16_t)(i / FrameDecoder::MaxSamplesPerFrame),
+                                              (uint32_t)(i + 1 - FrameDecoder::MaxSamplesPerFrame) * 1000, 1000, stream.data() + size);
+    }
+    stream.resize(size);
+    return stream;
+}
+
+static void report(const char *name, int64_t ns, double checksum)
+{
+    double samples = (double)StreamSamples * Rounds;
+    printf("%-22s %8.1f Msamples/s  %6.2f ns/sample  (%g)\n", name, samples / (ns / 1.0e3), ns / samples, checksum);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The streams are clean, so a gap means the benchmark measured the
+// resync path instead of the decode it claims to
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void checkGaps(const char *name, uint64_t gaps)
+{
+    if (gaps == 0)
+        return;
+    fprintf(stderr, "%s: %llu sequence gaps in a clean stream\n", name, (unsigned long long)gaps);
+    exit(EXIT_FAILURE);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Validate and convert through the ring, as the pipeline does
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void benchPerFrame(const std::vector<uint8_t> &stream, int version)
+{
+    FrameDecoder decoder;
+    CprSample sample;
+    double checksum = 0.0;
+
+    int64_t start = monotonicNanoseconds();
+    for (int round = 0; round < Rounds; round++) {
+        const char *data = (const char *)stream.data();
+        int len = (int)stream.size();
+        decoder.discardBuffered();      // each round is a fresh connection, its sequence starts over
+        while (len > 0) {
+            int fed = decoder.feed(data, len);
+            data += fed;
+            len -= fed;
+            while (decoder.decodeNext(&sample))
+                checksum += sample.acl_len;
+        }
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "v%d per frame", version);
+    report(name, monotonicNanoseconds() - start, checksum);
+    checkGaps(name, decoder.sequenceGaps());
+}
+
+static void benchBatch(const std::vector<uint8_t> &stream, int version, BatchDecoder::Kernel kernel)
+{
+    FrameDecoder decoder;
+    static uint8_t payloads[BatchDecoder::MaxBatch * FrameDecoder::PayloadSize + BatchDecoder::InputPadding];
+    static BatchDecoder::Output out;
+    double checksum = 0.0;
+
+    int64_t start = monotonicNanoseconds();
+    for (int round = 0; round < Rounds; round++) {
+        const char *data = (const char *)stream.data();
+        int len = (int)stream.size();
+        decoder.discardBuffered();      // each round is a fresh connection, its sequence starts over
+        while (len > 0) {
+            int fed = decoder.feed(data, len);
+            data += fed;
+            len -= fed;
+            int count;
+            while ((count = decoder.nextPayloads(payloads, BatchDecoder::MaxBatch)) > 0) {
+                BatchDecoder::decode(payloads, count, &out, kernel);
+                checksum += out.acl_len[count - 1];
+            }
+        }
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "v%d batch %s", version, BatchDecoder::kernelName(kernel));
+    report(name, monotonicNanoseconds() - start, checksum);
+    checkGaps(name, decoder.sequenceGaps());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Conversion alone, on payloads that are already validated
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void benchConvert(const std::vector<uint8_t> &stream, BatchDecoder::Kernel kernel)
+{
+    std::vector<uint8_t> payloads(StreamSamples * FrameDecoder::PayloadSize + BatchDecoder::InputPadding);
+    FrameDecoder decoder;
+    size_t offset = 0;
+    for (int i = 0; i < StreamSamples; ) {       // feed() takes as much as fits into the ring
+        offset += decoder.feed((const char *)stream.data() + offset, (int)(stream.size() - offset));
+        i += decoder.nextPayloads(payloads.data() + i * FrameDecoder::PayloadSize, StreamSamples - i);
+    }
+    static BatchDecoder::Output out;
+    double checksum = 0.0;
+
+    int64_t start = monotonicNanoseconds();
+    for (int round = 0; round < Rounds; round++) {
+        for (int i = 0; i < StreamSamples; i += BatchDecoder::MaxBatch) {
+            BatchDecoder::decode(payloads.data() + i * FrameDecoder::PayloadSize, BatchDecoder::MaxBatch, &out, kernel);
+            checksum += out.acl_len[0];
+        }
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "convert only %s", BatchDecoder::kernelName(kernel));
+    report(name, monotonicNanoseconds() - start, checksum);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Compression scoring for every device at once, samples interleaved as
+// the pool would feed them: 100 Hz each, 110 compressions per minute
+// 55 mm deep with some noise, each device at its own phase
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void benchCompressions()
+{
+    std::vector<float> displacement(StreamSamples);
+    srand(1);
+    for (int i = 0; i < StreamSamples; i++) {
+        int device = i % AppConfig::MaxDevices;
+        double t = (i / AppConfig::MaxDevices) * 0.01 + device * 0.05;
+        displacement[i] = (float)(0.0275 * (1.0 - cos(2.0 * M_PI * t * 110.0 / 60.0)) + (rand() % 1001 - 500) * 1.0e-6);
+    }
+    CompressionDetector detectors[AppConfig::MaxDevices];
+    uint64_t found = 0;
+
+    int64_t start = monotonicNanoseconds();
+    for (int round = 0; round < Rounds; round++) {
+        int64_t first = (int64_t)round * (StreamSamples / AppConfig::MaxDevices) * 10000000;
+        for (int i = 0; i < StreamSamples; i++)
+            found += detectors[i % AppConfig::MaxDevices].addSample(first + (i / AppConfig::MaxDevices) * 10000000LL, displacement[i]);
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "compressions %d dev", AppConfig::MaxDevices);
+    report(name, monotonicNanoseconds() - start, (double)found);
+}
+
+void runDecodeBenchmark()
+{
+    const BatchDecoder::Kernel kernels[] = { BatchDecoder::Scalar, BatchDecoder::Sse2, BatchDecoder::Avx2 };
+
+    printf("%d samples x %d rounds, best kernel: %s\n", StreamSamples, Rounds, BatchDecoder::kernelName(BatchDecoder::Best));
+    for (int version = 1; version <= FrameDecoder::MaxVersion; version++) {     // XOR, CRC-32C, multi-sample frames
+        std::vector<uint8_t> stream = makeStream(version);
+        benchPerFrame(stream, version);
+        for (BatchDecoder::Kernel kernel : kernels) {
+            if (BatchDecoder::isSupported(kernel))
+                benchBatch(stream, version, kernel);
+        }
+    }
+    std::vector<uint8_t> stream = makeStream(1);
+    for (BatchDecoder::Kernel kernel : kernels) {
+        if (BatchDecoder::isSupported(kernel))
+            benchConvert(stream, kernel);
+    }
+    benchCompressions();
+    fflush(stdout);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Every device at once through DevicePipelines on a pool of threads
+// workers: feed socket-sized chunks, drain the samples, until all of it
+// is decoded. Returns the samples drained.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static uint64_t benchPool(const std::vector<uint8_t> &stream, int threads, int64_t *ns)
+{
+    ProcessingPool pool(threads);
+    DevicePipeline *pipelines[AppConfig::MaxDevices];
+    size_t offsets[AppConfig::MaxDevices] = {};
+    int rounds[AppConfig::MaxDevices] = {};
+    DevicePipeline::Chunk chunk;
+    CprSample sample;
+    uint64_t drained = 0;
+
+    int64_t start = monotonicNanoseconds();
+    for (int i = 0; i < AppConfig::MaxDevices; i++)
+        pipelines[i] = new DevicePipeline(&pool, start);
+
+    bool feeding = true;
+    while (true) {
+        bool idle = !feeding;
+        feeding = false;
+        for (int i = 0; i < AppConfig::MaxDevices; i++) {
+            DevicePipeline *pipeline = pipelines[i];
+            while (rounds[i] < PoolRounds && !pipeline->isBackedUp()) {
+                chunk.len = (int)qMin(stream.size() - offsets[i], (size_t)DevicePipeline::ChunkSize);
+                memcpy(chunk.data, stream.data() + offsets[i], chunk.len);
+                chunk.received = chunk.read_at = monotonicNanoseconds();
+                pipeline->submit(chunk);
+                offsets[i] += chunk.len;
+                if (offsets[i] == stream.size()) {
+                    offsets[i] = 0;
+                    rounds[i]++;
+                    pipeline->discardBuffered();
+                }
+            }
+            feeding = feeding || rounds[i] < PoolRounds;
+            idle = idle && pipeline->isIdle();      // before draining, so no sample comes after the last pop
+            while (pipeline->samples().pop(&sample))
+                drained++;
+        }
+        if (idle)
+            break;
+        QThread::yieldCurrentThread();
+    }
+    *ns = monotonicNanoseconds() - start;
+
+    pool.stop();
+    for (int i = 0; i < AppConfig::MaxDevices; i++) {
+        checkGaps("pool", pipelines[i]->sequenceGaps());
+        delete pipelines[i];
+    }
+    return drained;
+}
+
+void runPoolBenchmark(int max_threads)
+{
+    std::vector<uint8_t> stream = makeStream(FrameDecoder::MaxVersion);
+    double rate_one = 0.0;
+
+    printf("%d devices x %d samples x %d rounds, v%d frames\n", AppConfig::MaxDevices, StreamSamples, PoolRounds, FrameDecoder::MaxVersion);
+    for (int threads = 1; threads <= max_threads; threads++) {
+        int64_t ns;
+        uint64_t samples = benchPool(stream, threads, &ns);
+        double rate = samples / (ns / 1.0e3);
+        if (threads == 1)
+            rate_one = rate;
+        printf("%2d threads %8.2f Msamples/s  %5.2fx\n", threads, rate, rate_one > 0.0 ? rate / rate_one : 0.0);
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef DECODEBENCHMARK_H
+#define DECODEBENCHMARK_H
+
+// Decode throughput of the per-frame path against every BatchDecoder
+// kernel the CPU supports, and of compression scoring, printed to stdout
+// (--bench-decode)
+void runDecodeBenchmark();
+
+// Throughput of every device at once through the DevicePipelines, on a
+// ProcessingPool of 1..max_threads workers (--bench-pool)
+void runPoolBenchmark(int max_threads);
+
+#endif // DECODEBENCHMARK_H
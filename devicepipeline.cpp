@@ -0,0 +1,225 @@
+#include "devicepipeline.h"
+#include "monotonicclock.h"
+
+#include <math.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+DevicePipeline::DevicePipeline(ProcessingPool *pool, int64_t start_time) :
+    pool(pool),
+    start_time(start_time)
+{
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Queue raw bytes and make sure a pool thread will look at them
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::submit(const Chunk &chunk)
+{
+    input.push(chunk);                  // a full input counts an overflow; the decoder resyncs over the gap
+
+    // pairs with the fence in run() - either run() sees this chunk or we see scheduled == false
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!scheduled.exchange(true))
+        pool->schedule(this);
+}
+
+void DevicePipeline::discardBuffered()
+{
+    Chunk marker;
+    marker.received = marker.read_at = monotonicNanoseconds();
+    marker.len = -1;
+    if (!input.push(marker))
+        discard_pending.store(true);    // never lost: run() drops the decoder state before its next chunk
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!scheduled.exchange(true))
+        pool->schedule(this);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Unthrottled replay feeds only while this is false
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool DevicePipeline::isBackedUp() const
+{
+    return input.size() >= input.capacity() / 2 || output.size() >= output.capacity() / 2;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Everything submitted has been decoded and published
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool DevicePipeline::isIdle() const
+{
+    return input.size() == 0 && !discard_pending.load() && !scheduled.load();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Pool task: process a batch of input, then reschedule if more is left
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::run()
+{
+    Chunk chunk;
+    int64_t last_received = 0;
+    int64_t began = monotonicNanoseconds();
+
+    for (int i = 0; i < BatchChunks; i++) {
+        if (discard_pending.exchange(false)) {
+            chunk.len = -1;
+            process(chunk);
+        }
+        if (!input.pop(&chunk))
+            break;
+        process(chunk);
+        last_received = chunk.received;
+    }
+    if (last_received)
+        publish(last_received);
+    busy_time.fetch_add(monotonicNanoseconds() - began, std::memory_order_relaxed);
+
+    scheduled.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((input.size() > 0 || discard_pending.load()) && !scheduled.exchange(true))
+        pool->schedule(this);           // goes to this thread's deque, other devices may steal past it
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Decode one chunk and hand the samples to the plotting thread
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::process(const Chunk &chunk)
+{
+    CprSample sample;
+    const char *data = chunk.data;
+    int len = chunk.len;
+
+    if (len < 0) {
+        decoder.discardBuffered();
+        clock.reset();                  // the device may have restarted while we were away
+        return;
+    }
+
+    sample.read_at = chunk.read_at;
+    sample.gap = false;
+    current_received = chunk.received;
+
+    while (len > 0) {
+        int fed = decoder.feed(data, len);
+        data += fed;
+        len -= fed;
+
+        // validate everything that is complete, then convert it in one go
+        int count;
+        while ((count = decoder.nextPayloads(payloads, BatchDecoder::MaxBatch, recorder ? this : nullptr, ticks)) > 0) {
+            BatchDecoder::decode(payloads, count, &batch);
+            sample.decoded_at = monotonicNanoseconds();
+
+            // samples with device ticks are placed by the device clock, the others spread out
+            // over the time up to their arrival
+            bool ticked = decoder.hasTicks();
+            if (ticked) {
+                for (int i = 0; i < count; i++) {
+                    device_times[i] = clock.deviceTime(ticks[i]);
+                    clock.addObservation(device_times[i], chunk.received);
+                }
+            } else {
+                spreadArrivals(chunk.received, count);
+            }
+            if (decoder.gapBefore())
+                pushGap(ticked ? clock.toHost(device_times[0]) : device_times[0]);
+
+            for (int i = 0; i < count; i++) {
+                sample.timestamp = ticked ? clock.toHost(device_times[i]) : device_times[i];
+                if (sample.timestamp < last_timestamp)
+                    sample.timestamp = last_timestamp;  // plot keys never go backwards, even when the fit moves
+                last_timestamp = sample.timestamp;
+                sample.acl_x = batch.acl_x[i];
+                sample.acl_y = batch.acl_y[i];
+                sample.acl_z = batch.acl_z[i];
+                sample.acl_len = batch.acl_len[i];
+                sample.displacement = batch.displacement[i];
+                sample.velocity = batch.velocity[i];
+                sample.tap_count = batch.tap_count[i];
+                sample.cpr_good = batch.cpr_good[i] != 0;
+
+                metrics.addSample(sample);
+                compressions.addSample(sample.timestamp, sample.displacement);
+                sample.enqueued_at = monotonicNanoseconds();
+                output.push(sample);    // a full queue counts an overflow and drops the sample
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Plot times for count samples without device ticks that arrived at
+// received, into device_times. A read holds every frame sent since the
+// previous one, so they are spread evenly from the last sample's time up
+// to received - or over count sample periods, after a pause - instead of
+// all landing on one key.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::spreadArrivals(int64_t received, int count)
+{
+    int64_t since = received - last_timestamp;
+    if (last_timestamp > 0 && since > 0 && since <= 4 * count * arrival_period)
+        arrival_period += (since / count - arrival_period) / 16;    // streaming, not a pause: learn the period
+
+    int64_t start = received - count * arrival_period;
+    if (start < last_timestamp)
+        start = last_timestamp;
+    int64_t span = received - start;
+    for (int i = 0; i < count; i++)
+        device_times[i] = start + span * (i + 1) / count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Break the plotted lines where data was lost
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::pushGap(int64_t timestamp)
+{
+    CprSample marker;
+
+    marker.timestamp = timestamp > last_timestamp ? timestamp : last_timestamp;
+    marker.acl_x = marker.acl_y = marker.acl_z = marker.acl_len = NAN;
+    marker.displacement = marker.velocity = NAN;
+    marker.tap_count = 0;
+    marker.cpr_good = false;
+    marker.gap = true;
+    marker.read_at = marker.decoded_at = marker.enqueued_at = monotonicNanoseconds();
+    output.push(marker);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Record frames as they were received, whatever version they are
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::rawFrame(const uint8_t *frame, int len)
+{
+    recorder->write(device, current_received, frame, len);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Make counters, tap metrics and compression scores visible to other threads
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DevicePipeline::publish(int64_t now)
+{
+    metrics.update((now - start_time) / 1.0e9);
+
+    decoded_frames.store(decoder.decodedFrames(), std::memory_order_relaxed);
+    resync_count.store(decoder.resyncCount(), std::memory_order_relaxed);
+    checksum_errors.store(decoder.checksumErrors(), std::memory_order_relaxed);
+    protocol_version.store(decoder.version(), std::memory_order_relaxed);
+    lost_samples.store(decoder.lostSamples(), std::memory_order_relaxed);
+    duplicate_frames.store(decoder.duplicateFrames(), std::memory_order_relaxed);
+    reordered_frames.store(decoder.reorderedFrames(), std::memory_order_relaxed);
+    sequence_gaps.store(decoder.sequenceGaps(), std::memory_order_relaxed);
+    clock_skew.store(clock.skewPpm(), std::memory_order_relaxed);
+    taps_per_second.store(metrics.tapsPerSecond(), std::memory_order_relaxed);
+    taps_per_minute.store(metrics.tapsPerMinute(), std::memory_order_relaxed);
+    cpr_good.store(metrics.cprGood(), std::memory_order_relaxed);
+
+    const CompressionDetector::Compression &last = compressions.last();
+    compression_rate.store(compressions.isPaused(now) ? 0 : (int)(last.rate + 0.5f), std::memory_order_relaxed);
+    compression_depth.store((int)(last.depth * 1000.0f + 0.5f), std::memory_order_relaxed);
+    full_recoil.store(last.recoil_ok, std::memory_order_relaxed);
+    duty_cycle.store((int)(last.duty_cycle * 100.0f + 0.5f), std::memory_order_relaxed);
+    quality_score.store(compressions.score(), std::memory_order_relaxed);
+}
@@ -0,0 +1,142 @@
+#ifndef DEVICEPIPELINE_H
+#define DEVICEPIPELINE_H
+
+#include <atomic>
+#include <stdint.h>
+
+#include "batchdecoder.h"
+#include "clockestimator.h"
+#include "compressiondetector.h"
+#include "cprmetrics.h"
+#include "cprsample.h"
+#include "framedecoder.h"
+#include "processingpool.h"
+#include "sessionrecorder.h"
+#include "spscqueue.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Per-device processing: frame decode, unit conversion, recording,
+// tap/rate estimation and compression scoring, run as a task on the
+// shared ProcessingPool.
+//
+// The I/O thread hands raw socket reads over with submit(); the pipeline
+// schedules itself whenever input arrives and is not already queued, so
+// one device is processed by one pool thread at a time and the decoder
+// state needs no locking. Decoded samples go to the plotting thread
+// through samples(), with a gap marker wherever data was lost, the tap
+// metrics through atomics. Samples of v3 frames are timestamped from the
+// device's tick, mapped onto the host clock by a ClockEstimator; those of
+// older frames are spread evenly over the time before their socket read
+// arrived, so a burst does not pile up on one plot key.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class DevicePipeline : public PoolTask, private FrameSink
+{
+public:
+    static const int ChunkSize = 512;
+    static const int InputChunks = 1024;        // ~512 kB of socket data per device
+    static const int BatchChunks = 64;          // chunks per run before giving other devices a turn
+    static const int64_t DefaultPeriod = 10000000;  // ns, 100 Hz until the reads tell otherwise
+
+    // One socket read (or replayed frame); len < 0 drops a partial frame left in the decoder
+    struct Chunk {
+        int64_t received;           // plot timestamp of its last sample, unless they carry device ticks
+        int64_t read_at;
+        int len;
+        char data[ChunkSize];
+    };
+
+    DevicePipeline(ProcessingPool *pool, int64_t start_time);
+
+    // Every decoded frame is also passed to recorder; set before input arrives
+    void setRecorder(SessionRecorder *recorder, uint16_t device) { this->recorder = recorder; this->device = device; }
+
+    // Highest protocol version to accept (see FrameDecoder); set before input arrives
+    void setMaxVersion(int version) { decoder.setMaxVersion(version); }
+
+    // I/O thread
+    void submit(const Chunk &chunk);
+    void discardBuffered();
+    bool isBackedUp() const;
+    bool isIdle() const;
+
+    // Plotting thread
+    SpscQueue<CprSample> &samples() { return output; }
+
+    // Safe to call from any thread
+    uint64_t decodedFrames() const { return decoded_frames.load(std::memory_order_relaxed); }
+    uint64_t resyncCount() const { return resync_count.load(std::memory_order_relaxed); }
+    uint64_t checksumErrors() const { return checksum_errors.load(std::memory_order_relaxed); }
+    int protocolVersion() const { return protocol_version.load(std::memory_order_relaxed); }
+    uint64_t lostSamples() const { return lost_samples.load(std::memory_order_relaxed); }
+    uint64_t duplicateFrames() const { return duplicate_frames.load(std::memory_order_relaxed); }
+    uint64_t reorderedFrames() const { return reordered_frames.load(std::memory_order_relaxed); }
+    uint64_t sequenceGaps() const { return sequence_gaps.load(std::memory_order_relaxed); }
+    double clockSkew() const { return clock_skew.load(std::memory_order_relaxed); }   // ppm, device slower than host if > 0
+    uint64_t inputOverflows() const { return input.overflowCount(); }
+    uint64_t sampleOverflows() const { return output.overflowCount(); }
+    int tapsPerSecond() const { return taps_per_second.load(std::memory_order_relaxed); }
+    int tapsPerMinute() const { return taps_per_minute.load(std::memory_order_relaxed); }
+    bool cprGood() const { return cpr_good.load(std::memory_order_relaxed); }
+    int64_t busyTime() const { return busy_time.load(std::memory_order_relaxed); }     // ns the pool spent decoding, without the drain
+
+    // Last compression found by the CompressionDetector, and the rolling score (-1 before the first)
+    int compressionRate() const { return compression_rate.load(std::memory_order_relaxed); }
+    int compressionDepth() const { return compression_depth.load(std::memory_order_relaxed); }     // mm
+    bool fullRecoil() const { return full_recoil.load(std::memory_order_relaxed); }
+    int dutyCycle() const { return duty_cycle.load(std::memory_order_relaxed); }                   // %
+    int qualityScore() const { return quality_score.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    void process(const Chunk &chunk);
+    void publish(int64_t now);
+    void spreadArrivals(int64_t received, int count);
+    void pushGap(int64_t timestamp);
+    void rawFrame(const uint8_t *frame, int len) override;
+
+    ProcessingPool *pool;
+    int64_t start_time;
+
+    SpscQueue<Chunk> input{InputChunks};
+    SpscQueue<CprSample> output{8192};
+    std::atomic<bool> scheduled{false};
+    std::atomic<bool> discard_pending{false};   // discard marker that found the input full
+
+    // only touched inside run()
+    FrameDecoder decoder;
+    uint8_t payloads[BatchDecoder::MaxBatch * FrameDecoder::PayloadSize + BatchDecoder::InputPadding];
+    uint32_t ticks[BatchDecoder::MaxBatch];
+    int64_t device_times[BatchDecoder::MaxBatch];   // ns; from the device clock or spread over arrival
+    BatchDecoder::Output batch;
+    CprMetrics metrics;
+    CompressionDetector compressions;
+    ClockEstimator clock;
+    SessionRecorder *recorder = nullptr;
+    uint16_t device = 0;
+    int64_t current_received = 0;
+    int64_t last_timestamp = 0;     // plot keys never go backwards
+    int64_t arrival_period = DefaultPeriod;     // ns between untimed samples, learned from the reads
+
+    std::atomic<int64_t> busy_time{0};
+    std::atomic<uint64_t> decoded_frames{0};
+    std::atomic<uint64_t> resync_count{0};
+    std::atomic<uint64_t> checksum_errors{0};
+    std::atomic<int> protocol_version{1};
+    std::atomic<uint64_t> lost_samples{0};
+    std::atomic<uint64_t> duplicate_frames{0};
+    std::atomic<uint64_t> reordered_frames{0};
+    std::atomic<uint64_t> sequence_gaps{0};
+    std::atomic<double> clock_skew{0.0};
+    std::atomic<int> taps_per_second{0};
+    std::atomic<int> taps_per_minute{0};
+    std::atomic<bool> cpr_good{false};
+    std::atomic<int> compression_rate{0};
+    std::atomic<int> compression_depth{0};
+    std::atomic<bool> full_recoil{false};
+    std::atomic<int> duty_cycle{0};
+    std::atomic<int> quality_score{-1};
+};
+
+#endif // DEVICEPIPELINE_H
@@ -0,0 +1,342 @@
+#include "framedecoder.h"
+#include "crc32c.h"
+
+#include <math.h>
+#include <string.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+FrameDecoder::FrameDecoder()
+{
+    memset(buffer, 0, sizeof(buffer));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Append received bytes, returns how many of them fit into the buffer
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int FrameDecoder::feed(const char *data, int len)
+{
+    if (len > freeSpace())
+        len = freeSpace();
+
+    uint32_t pos = tail & (BufferSize - 1);
+    int first = BufferSize - (int)pos;              // room before the wrap point
+    if (first > len)
+        first = len;
+    memcpy(buffer + pos, data, first);
+    memcpy(buffer, data + first, len - first);
+    tail += len;
+    return len;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Decode the next sample; false if more bytes are needed
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool FrameDecoder::decodeNext(CprSample *sample)
+{
+    uint8_t payload[PayloadSize];
+
+    if (nextPayloads(payload, 1) == 0)
+        return false;
+    decodePayload(payload, sample);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Copy the payloads of up to max validated samples back to back into
+// payloads, returns how many; the caller converts them (see BatchDecoder)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int FrameDecoder::nextPayloads(uint8_t *payloads, int max, FrameSink *sink, uint32_t *ticks)
+{
+    uint8_t scratch[MaxWireFrameSize];
+    int count = 0;
+
+    gap_before = false;
+    while (count < max) {
+        const uint8_t *frame;
+        if (frame_pending > 0) {        // the rest of a multi-sample frame
+            frame = view(scratch, frame_size);
+        } else {
+            frame = nextFrame(scratch);
+            if (!frame)
+                break;
+            if (frame_header == V3HeaderSize && !trackSequence(frame)) {
+                frame_pending = 0;
+                skip(frame_size);
+                continue;
+            }
+            if (sink)
+                sink->rawFrame(frame, frame_size);
+            decoded_frames++;
+        }
+
+        if (gap_pending) {              // lost data ends the batch, the next one starts with the gap
+            if (count > 0)
+                break;
+            gap_before = true;
+            gap_pending = false;
+        }
+        bool ticked = frame_header == V3HeaderSize;
+        if (count > 0 && ticked != has_ticks)   // the samples of a batch either all have device ticks or none
+            break;
+        has_ticks = ticked;
+
+        uint8_t *out = payloads + count * PayloadSize;
+        if (frame_samples == 1) {       // v1/v2 or a one-sample v3, keep the copy a fixed size
+            memcpy(out, frame + frame_header, PayloadSize);
+            if (ticks)
+                ticks[count] = frame_tick;
+            count++;
+            frame_pending = 0;
+            skip(frame_size);
+            continue;
+        }
+
+        int first = frame_samples - frame_pending;
+        int n = frame_pending < max - count ? frame_pending : max - count;
+        memcpy(out, frame + frame_header + first * PayloadSize, n * PayloadSize);
+        if (ticks) {
+            for (int i = 0; i < n; i++)
+                ticks[count + i] = frame_tick + (uint32_t)((first + i) * frame_period);
+        }
+        count += n;
+        frame_pending -= n;
+        if (frame_pending == 0)
+            skip(frame_size);
+    }
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Find and validate the next frame of any version; null if more bytes
+// are needed
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+const uint8_t *FrameDecoder::nextFrame(uint8_t *scratch)
+{
+    while (bytesAvailable() >= 4) {
+        if (byteAt(0) != Header1 || byteAt(1) != Header2) {   // not at a header - hunt for the next one
+            reject(false);
+            continue;
+        }
+
+        uint8_t version = byteAt(2);
+        int size = 0;
+        if (version == Version2 && max_version >= 2)
+            size = V2WireFrameSize;
+        else if (version == Version3 && max_version >= 3 && byteAt(3) >= 1 && byteAt(3) <= MaxSamplesPerFrame)
+            size = v3FrameSize(byteAt(3));
+
+        // a v1 frame followed by the next header is taken as v1 rather than
+        // stalling until there are as many bytes as the CRC checked frame needs -
+        // unless this connection, or right after a reconnect the one before,
+        // sent frames of that version
+        bool crc_only = version_seen >= 2;
+        bool crc_first = crc_only || (size > 0 && version <= previous_version);
+        bool longer = size > 0 && bytesAvailable() < size;
+        if (longer && (crc_first || bytesAvailable() <= WireFrameSize || byteAt(WireFrameSize) != Header1))
+            return nullptr;
+        if (size > 0 && !longer) {
+            const uint8_t *frame = checkCrc(scratch, version, size);
+            if (frame)
+                return frame;
+        }
+        if (crc_only) {                                         // no v1 once CRC checked frames came in
+            reject(true);
+            continue;
+        }
+
+        if (bytesAvailable() < WireFrameSize)                   // partial frame - wait for the rest
+            return nullptr;
+        const uint8_t *frame = view(scratch, WireFrameSize);
+        if (frame[WireFrameSize - 1] != calculateChecksum(frame + 1, FrameSize)) {
+            if (longer)                                         // not v1 after all, wait for the rest
+                return nullptr;
+            reject(true);
+            continue;
+        }
+
+        previous_version = 1;           // this connection speaks v1, whatever the last one did
+        frame_size = WireFrameSize;
+        frame_header = 2;
+        frame_samples = frame_pending = 1;
+        frame_tick = 0;
+        frame_period = 0;
+        in_sync = true;
+        return frame;
+    }
+    return nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Check the CRC of a complete v2/v3 candidate, take it over if it matches
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+const uint8_t *FrameDecoder::checkCrc(uint8_t *scratch, int version, int size)
+{
+    const uint8_t *frame = view(scratch, size);
+    const uint8_t *trailer = frame + size - 4;
+    uint32_t crc = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) | ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+    if (crc != crc32c(frame + 2, size - 6))
+        return nullptr;
+
+    frame_size = size;
+    if (version == Version2) {
+        frame_header = 3;
+        frame_samples = 1;
+        frame_tick = 0;
+        frame_period = 0;
+    } else {
+        frame_header = V3HeaderSize;
+        frame_samples = frame[3];
+        frame_tick = (uint32_t)frame[6] | ((uint32_t)frame[7] << 8) | ((uint32_t)frame[8] << 16) | ((uint32_t)frame[9] << 24);
+        frame_period = frame[10] | (frame[11] << 8);
+    }
+    frame_pending = frame_samples;
+    version_seen = version;
+    in_sync = true;
+    return frame;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Account for the sequence number of a v3 frame; false drops the frame
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool FrameDecoder::trackSequence(const uint8_t *frame)
+{
+    int sequence = frame[4] | (frame[5] << 8);
+    uint32_t tick = frame_tick;
+    int diff = (int16_t)(uint16_t)(sequence - last_sequence);
+
+    if (last_sequence >= 0 && diff <= 0 && diff > -SequenceWindow) {
+        uint64_t bit = (uint64_t)1 << -diff;
+        if (sequence_seen & bit) {
+            duplicate_frames++;
+        } else {
+            sequence_seen |= bit;
+            reordered_frames++;                     // its samples were counted as lost at the gap already
+        }
+        return false;
+    }
+
+    if (last_sequence >= 0 && diff > 1) {
+        // the device ticks tell how many samples were in the missing frames;
+        // a tick running backwards means the device restarted
+        int32_t missing = (int32_t)(tick - next_tick);
+        if (frame_period > 0 && missing > 0)
+            lost_samples += (uint32_t)missing / (uint32_t)frame_period;
+        sequence_gaps++;
+        gap_pending = true;
+    } else if (last_sequence >= 0 && diff != 1) {   // far out of the window - a restarted device
+        sequence_gaps++;
+        gap_pending = true;
+    }
+
+    sequence_seen = (diff > 0 && diff < SequenceWindow && last_sequence >= 0) ? (sequence_seen << diff) | 1 : 1;
+    last_sequence = sequence;
+    next_tick = tick + (uint32_t)(frame_samples * frame_period);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Not a frame at the read position. Header bytes may just as well be
+// part of a payload, so only drop one byte and look again
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void FrameDecoder::reject(bool bad_checksum)
+{
+    if (bad_checksum)
+        checksum_errors++;
+    if (in_sync) {
+        resync_count++;
+        in_sync = false;
+        gap_pending = true;
+    }
+    skip(1);
+    skipped_bytes++;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Drop buffered bytes and counters
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void FrameDecoder::reset()
+{
+    head = tail = 0;
+    in_sync = true;
+    version_seen = 1;
+    previous_version = 1;
+    frame_pending = 0;
+    last_sequence = -1;
+    gap_pending = gap_before = false;
+    decoded_frames = 0;
+    resync_count = 0;
+    checksum_errors = 0;
+    skipped_bytes = 0;
+    lost_samples = 0;
+    duplicate_frames = 0;
+    reordered_frames = 0;
+    sequence_gaps = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Drop buffered bytes but keep the counters - a partial frame left over
+// from a closed connection must not be glued to the next one, and the
+// next connection may be to different firmware, restarted sequence
+// numbers included. Whatever was sent in between is a gap
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void FrameDecoder::discardBuffered()
+{
+    skipped_bytes += bytesAvailable();
+    head = tail;
+    in_sync = true;
+    if (version_seen >= 2)
+        previous_version = version_seen;
+    version_seen = 1;
+    frame_pending = 0;
+    last_sequence = -1;
+    gap_pending = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// XOR over everything between the 0x86 header and the checksum byte
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+uint8_t FrameDecoder::calculateChecksum(const uint8_t *frame, int len)
+{
+    uint8_t checksum = 0;
+    for (int i = 1; i < len - 1; i++)   // start from 1 - ignoring the header
+        checksum = checksum ^ frame[i];
+    return checksum;
+}
+
+void FrameDecoder::peek(uint8_t *dst, int len) const
+{
+    uint32_t pos = head & (BufferSize - 1);
+    int first = BufferSize - (int)pos;              // bytes before the wrap point
+    if (first > len)
+        first = len;
+    memcpy(dst, buffer + pos, first);
+    memcpy(dst + first, buffer, len - first);
+}
+
+void FrameDecoder::skip(int len)
+{
+    head += len;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Convert a validated payload into physical units
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void FrameDecoder::decodePayload(const uint8_t *payload, CprSample *sample)
+{
+    int16_t x = (int16_t)(payload[0] | (payload[1] << 8));
+    int16_t y = (int16_t)(payload[2] | (payload[3] << 8));
+    int16_t z = (int16_t)(payload[4] | (payload[5] << 8));
+    uint16_t displacement_raw = (uint16_t)(payload[6] | (payload[7] << 8));
+    int16_t velocity_raw = (int16_t)(payload[8] | (payload[9] << 8));
+
+    sample->acl_x = ((float)x / 1.0e4);
+    sample->acl_y = ((float)y / 1.0e4);
+    sample->acl_z = ((float)z / 1.0e4);
+    sample->acl_len = sqrt((sample->acl_x * sample->acl_x) + (sample->acl_y * sample->acl_y) + (sample->acl_z * sample->acl_z));
+    sample->displacement = (float)((float)displacement_raw / 1.0e4);
+    sample->velocity = (float)((float)velocity_raw / 1.0e4);
+    sample->tap_count = payload[10];
+    sample->cpr_good = payload[11] != 0;
+}
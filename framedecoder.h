@@ -0,0 +1,171 @@
+#ifndef FRAMEDECODER_H
+#define FRAMEDECODER_H
+
+#include <stdint.h>
+#include "cprsample.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Receives every validated frame exactly as it was on the wire
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class FrameSink
+{
+public:
+    virtual ~FrameSink() {}
+    virtual void rawFrame(const uint8_t *frame, int len) = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Incremental decoder for the manikin TCP stream.
+//
+// Every frame carries the same 12 byte payload:
+//   x y z (3 x int16) | displacement (uint16) | velocity (int16)
+//   | tap count (uint8) | cpr good (uint8)
+//
+// Version 1 (all firmware so far, 15 bytes):
+//   0xAA 0x86 | payload | XOR checksum
+// Version 2 (19 bytes):
+//   0xAA 0x86 | 0x02 | payload | CRC-32C of version + payload (LE)
+// Version 3 (14 + 12 K bytes), K = 1..MaxSamplesPerFrame samples:
+//   0xAA 0x86 | 0x03 | K | sequence (uint16) | device tick of the first
+//   sample (uint32, us) | sample period (uint16, us) | K payloads
+//   | CRC-32C of everything from the version byte on (LE)
+//
+// The version byte of v2/v3 can also be the first payload byte of a v1
+// frame, so a frame counts as v2/v3 only if its CRC matches; after the
+// first one the decoder stays on CRC checked frames until
+// discardBuffered(), and a corrupted frame can no longer slip through as
+// v1 with a 1 in 256 XOR match. The next connection may be to older
+// firmware that ignores the hello, so it starts out accepting v1 again;
+// only until its first frame, a candidate of the version the previous
+// connection used waits for all of its bytes and is tried with its CRC
+// first, so the first frame after a reconnect is not split up as v1
+// either. setMaxVersion() limits detection.
+//
+// Bytes are pushed with feed() as they come off the socket and kept in a
+// ring buffer, so a frame split across two reads is completed by the next
+// one. decodeNext() hands out every sample in order and resyncs on the
+// 0xAA 0x86 header after garbage or a bad checksum. nextPayloads() does
+// the same validation but only copies the payloads out, for BatchDecoder
+// to convert many of them at once; a v3 frame that does not fit is handed
+// out over several calls.
+//
+// v3 sequence numbers are tracked: a jump forward counts the samples in
+// between as lost (from the device ticks), a frame seen again is dropped
+// as a duplicate, and one that arrives after its successors is dropped as
+// reordered so samples stay in time order. Lost data of any kind - a
+// sequence gap, a resync, a dropped connection - ends the current
+// nextPayloads() batch, and gapBefore() tells the caller to break the
+// line before the next one.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class FrameDecoder
+{
+public:
+    static const int PayloadSize = 12;
+    static const int FrameSize = 14;                // v1: 0x86 header + payload + checksum
+    static const int WireFrameSize = FrameSize + 1; // v1: including the leading 0xAA
+    static const int V2WireFrameSize = 2 + 1 + PayloadSize + 4;
+    static const int V3HeaderSize = 2 + 1 + 1 + 2 + 4 + 2;
+    static const int MaxSamplesPerFrame = 16;
+    static const int MaxWireFrameSize = V3HeaderSize + MaxSamplesPerFrame * PayloadSize + 4;
+    static const int BufferSize = 4096;             // must be a power of two
+
+    static const uint8_t Header1 = 0xAA;
+    static const uint8_t Header2 = 0x86;
+    static const uint8_t Version2 = 0x02;
+    static const uint8_t Version3 = 0x03;
+    static const int MaxVersion = 3;
+
+    // Sent by the client after connecting: 0xAA 0x86 0xF0 | highest version it reads | XOR.
+    // Firmware that knows it switches to the highest common version, older firmware ignores it.
+    static const uint8_t HelloType = 0xF0;
+    static const int HelloSize = 5;
+
+    FrameDecoder();
+
+    void setMaxVersion(int version) { max_version = version; }
+    int version() const { return version_seen; }
+
+    int feed(const char *data, int len);
+    bool decodeNext(CprSample *sample);
+    // ticks[i]: device time of sample i in us, if hasTicks() (v3 frames)
+    int nextPayloads(uint8_t *payloads, int max, FrameSink *sink = nullptr, uint32_t *ticks = nullptr);
+    void reset();
+    void discardBuffered();
+
+    int bytesAvailable() const { return (int)(tail - head); }
+    int freeSpace() const { return BufferSize - bytesAvailable(); }
+
+    uint64_t decodedFrames() const { return decoded_frames; }
+    uint64_t resyncCount() const { return resync_count; }
+    uint64_t checksumErrors() const { return checksum_errors; }
+    uint64_t skippedBytes() const { return skipped_bytes; }
+    uint64_t lostSamples() const { return lost_samples; }
+    uint64_t duplicateFrames() const { return duplicate_frames; }
+    uint64_t reorderedFrames() const { return reordered_frames; }
+    uint64_t sequenceGaps() const { return sequence_gaps; }
+
+    // About the batch the last nextPayloads() returned: data was lost right
+    // before it, and its samples carry device ticks
+    bool gapBefore() const { return gap_before; }
+    bool hasTicks() const { return has_ticks; }
+
+    static uint8_t calculateChecksum(const uint8_t *frame, int len);
+    static void decodePayload(const uint8_t *payload, CprSample *sample);
+    static int v3FrameSize(int samples) { return V3HeaderSize + samples * PayloadSize + 4; }
+
+private:
+    const uint8_t *nextFrame(uint8_t *scratch);
+    const uint8_t *checkCrc(uint8_t *scratch, int version, int size);
+    bool trackSequence(const uint8_t *frame);
+    void reject(bool bad_checksum);
+    uint8_t byteAt(int offset) const { return buffer[(head + offset) & (BufferSize - 1)]; }
+    void peek(uint8_t *dst, int len) const;
+
+    // Frames are validated where they are in the ring; only one that wraps
+    // around the end is copied to scratch first
+    const uint8_t *view(uint8_t *scratch, int len) const
+    {
+        uint32_t pos = head & (BufferSize - 1);
+        if (pos + len <= (uint32_t)BufferSize)
+            return buffer + pos;
+        peek(scratch, len);
+        return scratch;
+    }
+    void skip(int len);
+
+    uint8_t buffer[BufferSize];
+    uint32_t head = 0;          // free running read index
+    uint32_t tail = 0;          // free running write index
+    bool in_sync = true;
+    int max_version = MaxVersion;
+    int version_seen = 1;
+    int previous_version = 1;   // of the connection before discardBuffered(), until the next one sends a frame
+
+    // the validated frame at the read position while its samples are handed out
+    int frame_size = 0;
+    int frame_header = 0;           // payload offset
+    int frame_samples = 0;
+    uint32_t frame_tick = 0;        // device time of the first sample, us
+    int frame_period = 0;           // us between samples
+    int frame_pending = 0;          // samples not handed out yet
+
+    // v3 sequence tracking
+    static const int SequenceWindow = 64;
+    int last_sequence = -1;         // -1 until the first v3 frame
+    uint64_t sequence_seen = 0;     // bit n: last_sequence - n has arrived
+    uint32_t next_tick = 0;         // device tick the frame after last_sequence starts at
+    bool gap_pending = false;       // lost data not reported by gapBefore() yet
+    bool gap_before = false;
+    bool has_ticks = false;
+
+    uint64_t decoded_frames = 0;
+    uint64_t resync_count = 0;
+    uint64_t checksum_errors = 0;
+    uint64_t skipped_bytes = 0;
+    uint64_t lost_samples = 0;
+    uint64_t duplicate_frames = 0;
+    uint64_t reordered_frames = 0;
+    uint64_t sequence_gaps = 0;
+};
+
+#endif // FRAMEDECODER_H
@@ -0,0 +1,80 @@
+#include "frameencoder.h"
+#include "crc32c.h"
+
+static void putLittleEndian16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void putLittleEndian32(uint8_t *out, uint32_t value)
+{
+    putLittleEndian16(out, (uint16_t)(value & 0xFFFF));
+    putLittleEndian16(out + 2, (uint16_t)(value >> 16));
+}
+
+static void putPayload(const RawSample &sample, uint8_t *payload)
+{
+    putLittleEndian16(payload + 0, (uint16_t)sample.x);
+    putLittleEndian16(payload + 2, (uint16_t)sample.y);
+    putLittleEndian16(payload + 4, (uint16_t)sample.z);
+    putLittleEndian16(payload + 6, sample.displacement);
+    putLittleEndian16(payload + 8, (uint16_t)sample.velocity);
+    payload[10] = sample.tap_count;
+    payload[11] = sample.cpr_good;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Write one single sample frame of protocol version 1 or 2 to out,
+// returns its size in bytes
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int FrameEncoder::encode(const RawSample &sample, uint8_t *out, int version)
+{
+    out[0] = FrameDecoder::Header1;
+    out[1] = FrameDecoder::Header2;
+
+    if (version >= 2) {
+        out[2] = FrameDecoder::Version2;
+        putPayload(sample, out + 3);
+        putLittleEndian32(out + 3 + FrameDecoder::PayloadSize, crc32c(out + 2, 1 + FrameDecoder::PayloadSize));
+        return FrameDecoder::V2WireFrameSize;
+    }
+
+    putPayload(sample, out + 2);
+    out[14] = FrameDecoder::calculateChecksum(out + 1, FrameDecoder::FrameSize);
+    return FrameDecoder::WireFrameSize;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Write count (1..MaxSamplesPerFrame) samples as one v3 frame; tick is
+// the device time of the first one, period the spacing, both in us
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int FrameEncoder::encodeBatch(const RawSample *samples, int count, uint16_t sequence, uint32_t tick, uint16_t period, uint8_t *out)
+{
+    int size = FrameDecoder::v3FrameSize(count);
+
+    out[0] = FrameDecoder::Header1;
+    out[1] = FrameDecoder::Header2;
+    out[2] = FrameDecoder::Version3;
+    out[3] = (uint8_t)count;
+    putLittleEndian16(out + 4, sequence);
+    putLittleEndian32(out + 6, tick);
+    putLittleEndian16(out + 10, period);
+    for (int i = 0; i < count; i++)
+        putPayload(samples[i], out + FrameDecoder::V3HeaderSize + i * FrameDecoder::PayloadSize);
+    putLittleEndian32(out + size - 4, crc32c(out + 2, size - 6));
+    return size;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Write the hello a client sends to ask for protocol version (or lower)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int FrameEncoder::encodeHello(uint8_t version, uint8_t *out)
+{
+    out[0] = FrameDecoder::Header1;
+    out[1] = FrameDecoder::Header2;
+    out[2] = FrameDecoder::HelloType;
+    out[3] = version;
+    out[4] = FrameDecoder::calculateChecksum(out + 1, FrameDecoder::HelloSize - 1);
+    return FrameDecoder::HelloSize;
+}
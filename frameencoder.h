@@ -0,0 +1,32 @@
+#ifndef FRAMEENCODER_H
+#define FRAMEENCODER_H
+
+#include <stdint.h>
+
+#include "framedecoder.h"
+
+// Raw sensor values of one sample, in the units sent on the wire (1e-4)
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    uint16_t displacement;
+    int16_t velocity;
+    uint8_t tap_count;
+    uint8_t cpr_good;
+} RawSample;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Builds frames in the format FrameDecoder reads (used by the simulator)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class FrameEncoder
+{
+public:
+    static const int MaxFrameSize = FrameDecoder::MaxWireFrameSize;
+
+    static int encode(const RawSample &sample, uint8_t *out, int version = 1);
+    static int encodeBatch(const RawSample *samples, int count, uint16_t sequence, uint32_t tick, uint16_t period, uint8_t *out);
+    static int encodeHello(uint8_t version, uint8_t *out);
+};
+
+#endif // FRAMEENCODER_H
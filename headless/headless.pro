@@ -0,0 +1,56 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = cprheadless
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../appconfig.cpp \
+    ../batchdecoder.cpp \
+    ../clockestimator.cpp \
+    ../compressiondetector.cpp \
+    ../connectionmanager.cpp \
+    ../crc32c.cpp \
+    ../cprmetrics.cpp \
+    ../decodebenchmark.cpp \
+    ../devicepipeline.cpp \
+    ../framedecoder.cpp \
+    ../frameencoder.cpp \
+    ../headlessrunner.cpp \
+    ../ingestionworker.cpp \
+    ../processingpool.cpp \
+    ../replaysource.cpp \
+    ../sessionrecorder.cpp \
+    main.cpp
+
+HEADERS += \
+    ../appconfig.h \
+    ../batchdecoder.h \
+    ../clockestimator.h \
+    ../compressiondetector.h \
+    ../connectionmanager.h \
+    ../crc32c.h \
+    ../cprmetrics.h \
+    ../cprsample.h \
+    ../decodebenchmark.h \
+    ../devicepipeline.h \
+    ../framedecoder.h \
+    ../frameencoder.h \
+    ../headlessrunner.h \
+    ../ingestionworker.h \
+    ../monotonicclock.h \
+    ../processingpool.h \
+    ../replaysource.h \
+    ../sessionfile.h \
+    ../sessionrecorder.h \
+    ../spscqueue.h
+
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,6 @@
+#include "headlessrunner.h"
+
+int main(int argc, char *argv[])
+{
+    return runHeadless(argc, argv);
+}
@@ -0,0 +1,258 @@
+#include "headlessrunner.h"
+#include "decodebenchmark.h"
+#include "monotonicclock.h"
+
+#include <QCoreApplication>
+
+#include <signal.h>
+#include <stdio.h>
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void handleSignal(int)
+{
+    interrupted = 1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+HeadlessRunner::HeadlessRunner(const AppConfig &config, QObject *parent) :
+    QObject(parent),
+    config(config),
+    pool(config.threads)
+{
+    qRegisterMetaType<QAbstractSocket::SocketError>();
+
+    start_time = monotonicNanoseconds();    // before the pipelines, their metrics count from it too
+    for (int i = 0; i < config.devices.size(); i++) {
+        Device *device = new Device;
+        device->pipeline = new DevicePipeline(&pool, start_time);
+        device->pipeline->setRecorder(&recorder, (uint16_t)i);
+        device->worker = new IngestionWorker(config.devices[i].address, config.devices[i].port, device->pipeline);
+        device->worker->setProtocol(config.protocol);
+        if (!config.replay_file.isEmpty())
+            device->worker->setReplay(config.replay_file, config.replay_speed, (uint16_t)i);
+        device->worker->moveToThread(&ingestionThread);
+
+        connect(&ingestionThread, &QThread::started, device->worker, &IngestionWorker::start);
+        connect(&ingestionThread, &QThread::finished, device->worker, &QObject::deleteLater);
+        connect(device->worker, &IngestionWorker::connectionFailed, this, &HeadlessRunner::connectionFailed);
+        connect(device->worker, &IngestionWorker::socketError, this, &HeadlessRunner::socketError);
+        connect(device->worker, &IngestionWorker::replayFinished, this, &HeadlessRunner::replayFinished);
+        devices.append(device);
+    }
+
+    connect(&processTimer, &QTimer::timeout, this, &HeadlessRunner::process);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Destructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+HeadlessRunner::~HeadlessRunner()
+{
+    shutdown();
+    foreach (Device *device, devices)
+        delete device->pipeline;
+    qDeleteAll(devices);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Open the recording and start all ingestion threads
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool HeadlessRunner::start()
+{
+    if (!config.record_file.isEmpty() && !recorder.open(config.record_file)) {
+        fprintf(stderr, "Could not record to %s: %s\n", qPrintable(config.record_file), qPrintable(recorder.errorString()));
+        return false;
+    }
+
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+
+    ingestionThread.start();
+    processTimer.start(10);
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Drain the sample queues - metrics are computed on the pool already
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::process()
+{
+    double key = (monotonicNanoseconds() - start_time) / 1.0e9;
+    CprSample sample;
+
+    foreach (Device *device, devices) {
+        while (device->pipeline->samples().pop(&sample))
+            ;
+    }
+
+    if (key - last_stats_key >= config.stats_interval) {
+        printStats();
+        last_stats_key = key;
+    }
+
+    bool replayed = replay_done;
+    foreach (Device *device, devices)
+        replayed = replayed && device->pipeline->isIdle();     // not done until the pool has decoded it all
+
+    if (interrupted || replayed || (config.duration > 0 && key >= config.duration)) {
+        printStats();
+        if (replayed)
+            printReplayReport();
+        shutdown();
+        QCoreApplication::quit();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// One status line per device
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::printStats()
+{
+    for (int i = 0; i < devices.size(); i++) {
+        const Device *device = devices[i];
+        printf("device %d: v%d frames %llu  resyncs %llu  checksum errors %llu  queue overflows %llu  taps/min %d  cpr %s\n",
+               i,
+               device->pipeline->protocolVersion(),
+               (unsigned long long)device->pipeline->decodedFrames(),
+               (unsigned long long)device->pipeline->resyncCount(),
+               (unsigned long long)device->pipeline->checksumErrors(),
+               (unsigned long long)(device->pipeline->inputOverflows() + device->pipeline->sampleOverflows()),
+               device->pipeline->tapsPerMinute(),
+               device->pipeline->cprGood() ? "good" : "-");
+        if (device->pipeline->qualityScore() >= 0) {
+            printf("device %d: compressions %d/min  depth %d mm  recoil %s  duty cycle %d%%  score %d\n",
+                   i,
+                   device->pipeline->compressionRate(),
+                   device->pipeline->compressionDepth(),
+                   device->pipeline->fullRecoil() ? "full" : "incomplete",
+                   device->pipeline->dutyCycle(),
+                   device->pipeline->qualityScore());
+        }
+        if (device->pipeline->protocolVersion() >= 3) {
+            printf("device %d: sequence gaps %llu  lost samples %llu  duplicates %llu  reordered %llu  clock skew %+.1f ppm\n",
+                   i,
+                   (unsigned long long)device->pipeline->sequenceGaps(),
+                   (unsigned long long)device->pipeline->lostSamples(),
+                   (unsigned long long)device->pipeline->duplicateFrames(),
+                   (unsigned long long)device->pipeline->reorderedFrames(),
+                   device->pipeline->clockSkew());
+        }
+        if (config.replay_file.isEmpty()) {
+            const ConnectionManager *link = device->worker->link();
+            printf("device %d: link %s  attempts %llu  reconnects %llu  connect time %.1f ms  downtime %.1f s\n",
+                   i,
+                   link->isConnected() ? "up" : "down",
+                   (unsigned long long)link->connectAttempts(),
+                   (unsigned long long)link->reconnects(),
+                   link->lastConnectTime() / 1.0e6,
+                   link->downtime(monotonicNanoseconds()) / 1.0e9);
+        }
+    }
+    printf("pool: %d threads  tasks %llu  steals %llu\n",
+           pool.threadCount(), (unsigned long long)pool.tasksRun(), (unsigned long long)pool.steals());
+    if (recorder.isRecording())
+        printf("recorded %llu  dropped %llu\n", (unsigned long long)recorder.recordsWritten(), (unsigned long long)recorder.droppedRecords());
+    fflush(stdout);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Stop ingestion and flush the recording
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::shutdown()
+{
+    processTimer.stop();
+    if (ingestionThread.isRunning()) {
+        foreach (Device *device, devices)
+            QMetaObject::invokeMethod(device->worker, "stop", Qt::BlockingQueuedConnection);
+        ingestionThread.quit();
+        ingestionThread.wait();
+    }
+    pool.stop();                        // nothing may write to the recorder or a pipeline after this
+    recorder.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The replay file could not be read - nothing will ever arrive
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::connectionFailed(const QString &errorString)
+{
+    fprintf(stderr, "The following error occurred: %s.\n", qPrintable(errorString));
+    shutdown();
+    QCoreApplication::exit(EXIT_FAILURE);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Socket errors - the connection manager is already retrying
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::socketError(QAbstractSocket::SocketError socketError, const QString &errorString)
+{
+    Q_UNUSED(socketError);
+    for (int i = 0; i < devices.size(); i++) {
+        if (devices[i]->worker == sender()) {
+            fprintf(stderr, "device %d: %s, reconnecting (attempt %llu)\n",
+                    i, qPrintable(errorString), (unsigned long long)devices[i]->worker->link()->connectAttempts());
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// All devices replayed - the next process() reports once the pool is done
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::replayFinished(quint64 frames, qint64 nanoseconds)
+{
+    Q_UNUSED(frames);
+    replay_time = qMax(replay_time, (int64_t)nanoseconds);
+
+    foreach (Device *device, devices) {
+        if (device->worker == sender())
+            device->finished = true;
+    }
+    foreach (Device *device, devices) {
+        if (!device->finished)
+            return;
+    }
+    replay_done = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Decode throughput from the time the pool spent in the pipelines only;
+// unthrottled replay is paced by the drain, so the wall time is not it
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void HeadlessRunner::printReplayReport()
+{
+    uint64_t frames = 0;
+    int64_t busy = 0;
+    foreach (Device *device, devices) {
+        frames += device->pipeline->decodedFrames();
+        busy += device->pipeline->busyTime();
+    }
+
+    double seconds = busy / 1.0e9;
+    printf("replay: %llu frames decoded in %.3f s of pool time (%.0f frames/s), fed in %.3f s\n",
+           (unsigned long long)frames, seconds, seconds > 0.0 ? frames / seconds : 0.0, replay_time / 1.0e9);
+    fflush(stdout);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Headless main - no QGuiApplication and no widget is ever created
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    AppConfig config;
+    parseCommandLine(a, &config);
+    if (config.bench_decode || config.bench_pool > 0) {
+        if (config.bench_decode)
+            runDecodeBenchmark();
+        if (config.bench_pool > 0)
+            runPoolBenchmark(config.bench_pool);
+        return EXIT_SUCCESS;
+    }
+    HeadlessRunner runner(config);
+    if (!runner.start())
+        return EXIT_FAILURE;
+    return a.exec();
+}
@@ -0,0 +1,71 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QList>
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+
+#include "appconfig.h"
+#include "cprsample.h"
+#include "devicepipeline.h"
+#include "ingestionworker.h"
+#include "processingpool.h"
+#include "sessionrecorder.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Ingestion, decoding, recording and CPR metrics without any widgets.
+//
+// Runs under a QCoreApplication, either from the widget-free cprheadless
+// build (headless/headless.pro) or from CPRReader --headless. Devices share
+// one I/O thread and the processing pool like in the GUI, all of them
+// record into one session file, and a status line per device is printed
+// periodically. With the simulator this is the load test for the pool.
+//
+// Lost connections are retried by each worker's ConnectionManager with
+// its backoff, and said so on stderr; a replay file that cannot be read
+// ends the run with a failure exit code.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(const AppConfig &config, QObject *parent = nullptr);
+    ~HeadlessRunner();
+
+    bool start();
+
+private slots:
+    void process();
+    void connectionFailed(const QString &errorString);
+    void socketError(QAbstractSocket::SocketError socketError, const QString &errorString);
+    void replayFinished(quint64 frames, qint64 nanoseconds);
+
+private:
+    struct Device {
+        IngestionWorker* worker;
+        DevicePipeline* pipeline;
+        bool finished = false;
+    };
+
+    void printStats();
+    void printReplayReport();
+    void shutdown();
+
+    AppConfig config;
+    ProcessingPool pool;
+    QThread ingestionThread;
+    QList<Device*> devices;
+    SessionRecorder recorder;
+    QTimer processTimer;
+    int64_t start_time = 0;
+    double last_stats_key = 0.0;
+    bool replay_done = false;
+    int64_t replay_time = 0;            // ns until the last device's file was fed
+};
+
+// The whole headless application - --bench-decode or a HeadlessRunner - for both builds' main()
+int runHeadless(int argc, char *argv[]);
+
+#endif // HEADLESSRUNNER_H
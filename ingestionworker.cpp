@@ -0,0 +1,141 @@
+#include "ingestionworker.h"
+#include "frameencoder.h"
+#include "monotonicclock.h"
+
+#include <string.h>
+
+static_assert(ReplaySource::MaxFrameSize <= DevicePipeline::ChunkSize, "a replayed frame has to fit into one chunk");
+static_assert(FrameDecoder::MaxWireFrameSize <= ReplaySource::MaxFrameSize, "a recorded frame has to fit into the continuation records");
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+IngestionWorker::IngestionWorker(const QHostAddress &address, quint16 port, DevicePipeline *pipeline, QObject *parent) :
+    QObject(parent),
+    pipeline(pipeline)
+{
+    connection = new ConnectionManager(address, port, this);    // a child, so it moves to the worker thread with us
+    connect(connection, &ConnectionManager::connected, this, &IngestionWorker::linkUp);
+    connect(connection, &ConnectionManager::disconnected, this, &IngestionWorker::linkDown);
+    connect(connection, &ConnectionManager::readyRead, this, &IngestionWorker::readSocket);
+    connect(connection, &ConnectionManager::socketError, this, &IngestionWorker::socketError);
+}
+
+void IngestionWorker::setReplay(const QString &fileName, double speed, uint16_t device)
+{
+    replay_file = fileName;
+    replay.setSpeed(speed);
+    replay.setDevice(device);
+}
+
+void IngestionWorker::setProtocol(int version)
+{
+    protocol = version;
+    pipeline->setMaxVersion(version);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Connect - called once the worker thread is running
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::start()
+{
+    if (!replay_file.isEmpty()) {
+        startReplay();
+        return;
+    }
+    connection->open();                 // asynchronous, connected() follows once the manikin answers
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Close the connection
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::stop()
+{
+    if (replay_timer)
+        replay_timer->stop();
+    connection->close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Read TCP - straight into chunks for the processing pool
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::readSocket()
+{
+    QTcpSocket *socket = connection->socket();
+    DevicePipeline::Chunk chunk;
+
+    while (socket->bytesAvailable() > 0) {
+        chunk.len = (int)socket->read(chunk.data, DevicePipeline::ChunkSize);
+        if (chunk.len <= 0)
+            break;
+        chunk.received = chunk.read_at = monotonicNanoseconds();
+        pipeline->submit(chunk);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Connected - ask for the newest protocol version we read
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::linkUp()
+{
+    if (protocol > 1) {
+        uint8_t hello[FrameDecoder::HelloSize];
+        int len = FrameEncoder::encodeHello((uint8_t)protocol, hello);
+        connection->socket()->write((const char *)hello, len);
+    }
+    emit connected();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Disconnect case - the connection manager is already retrying
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::linkDown()
+{
+    pipeline->discardBuffered();
+    emit disconnected();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Open a recorded session in place of the socket
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::startReplay()
+{
+    if (!replay.open(replay_file)) {
+        emit connectionFailed(QString("%1: %2").arg(replay_file).arg(replay.errorString()));
+        return;
+    }
+
+    replay_timer = new QTimer(this);
+    replay_timer->setTimerType(Qt::PreciseTimer);
+    connect(replay_timer, &QTimer::timeout, this, &IngestionWorker::replayFrames);
+
+    replay_started = monotonicNanoseconds();
+    replay.start(replay_started);
+    replay_timer->start(replay.speed() > 0.0 ? 1 : 0);
+    emit connected();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Feed every frame that is due; unthrottled replay stops short of
+// overflowing the pipeline so it runs exactly as fast as it is drained
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void IngestionWorker::replayFrames()
+{
+    const int batch = 1024;
+    DevicePipeline::Chunk chunk;
+
+    for (int i = 0; replay.speed() > 0.0 || (i < batch && !pipeline->isBackedUp()); i++) {   // batches give the event loop a turn
+        if (!replay.nextFrame(monotonicNanoseconds(), &chunk.received))
+            break;
+        chunk.read_at = monotonicNanoseconds();
+        chunk.len = replay.frameSize();
+        memcpy(chunk.data, replay.frame(), chunk.len);
+        pipeline->submit(chunk);
+        replayed_frames++;
+    }
+
+    if (replay.atEnd()) {
+        replay_timer->stop();
+        emit replayFinished(replayed_frames, monotonicNanoseconds() - replay_started);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef INGESTIONWORKER_H
+#define INGESTIONWORKER_H
+
+#include <QObject>
+#include <QAbstractSocket>
+#include <QHostAddress>
+#include <QTimer>
+
+#include <atomic>
+
+#include "connectionmanager.h"
+#include "devicepipeline.h"
+#include "replaysource.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Socket I/O for one manikin.
+//
+// All workers share one I/O thread (see MainWindow), so a slow replot
+// never delays readyRead handling. Raw reads are handed to the device's
+// DevicePipeline, which decodes them on the processing pool.
+//
+// The link is kept up by a ConnectionManager, which reconnects on its own;
+// the pipeline's decoder and counters carry over from one connection to
+// the next. On every connect the worker asks for the newest protocol
+// version it reads (see FrameDecoder); firmware that does not know the
+// hello keeps sending v1, which is still decoded.
+//
+// With setReplay() the frames come from a recorded session instead of
+// the socket and go through exactly the same decode path.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class IngestionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    IngestionWorker(const QHostAddress &address, quint16 port, DevicePipeline *pipeline, QObject *parent = nullptr);
+
+    // Replay device's frames from fileName instead of connecting; speed 0 replays as fast as the pipeline keeps up
+    void setReplay(const QString &fileName, double speed, uint16_t device);
+
+    // Highest protocol version to ask for and accept, 1 sends no hello; set before start()
+    void setProtocol(int version);
+
+    // Safe to call from any thread
+    const ConnectionManager *link() const { return connection; }
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    void connected();
+    void connectionFailed(const QString &errorString);      // replay file could not be opened
+    void disconnected();
+    void socketError(QAbstractSocket::SocketError socketError, const QString &errorString);
+    void replayFinished(quint64 frames, qint64 nanoseconds);
+
+private slots:
+    void readSocket();
+    void linkUp();
+    void linkDown();
+    void replayFrames();
+
+private:
+    void startReplay();
+
+    ConnectionManager* connection;
+    DevicePipeline *pipeline;
+    int protocol = FrameDecoder::MaxVersion;
+
+    QString replay_file;
+    ReplaySource replay;
+    QTimer* replay_timer = nullptr;
+    int64_t replay_started = 0;
+    quint64 replayed_frames = 0;
+};
+
+#endif // INGESTIONWORKER_H
@@ -0,0 +1,74 @@
+#include "jitterbuffer.h"
+
+#include <math.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Buffer a sample (or gap marker) in timestamp order
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void JitterBuffer::push(const CprSample &sample)
+{
+    if (started && sample.timestamp < next_out) {
+        late_samples++;
+        return;
+    }
+    if (count == Capacity) {            // nothing pulled for a long time, keep the newest
+        dropFirst();
+        overflows++;
+    }
+    at(count++) = sample;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Next evenly spaced sample due at now - delay; false if there is none yet
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool JitterBuffer::pull(int64_t now, CprSample *sample)
+{
+    int64_t playout = now - delay;
+
+    while (count > 0) {
+        if (!started || at(0).timestamp > next_out) {
+            next_out = at(0).timestamp;     // first sample, or the ones before were overwritten
+            started = true;
+        }
+
+        // of what lies before next_out only the last sample is needed
+        while (count >= 2 && at(1).timestamp <= next_out)
+            dropFirst();
+        if (next_out > playout || count < 2)
+            return false;
+
+        const CprSample &a = at(0);
+        const CprSample &b = at(1);
+        if (a.gap || b.gap || b.timestamp - a.timestamp > MaxGap * period) {
+            bool report = !gap_out;
+            *sample = a;
+            sample->timestamp = next_out;
+            next_out += (b.timestamp - next_out + period - 1) / period * period;
+            dropFirst();
+            if (!report)
+                continue;
+
+            sample->acl_x = sample->acl_y = sample->acl_z = sample->acl_len = NAN;
+            sample->displacement = sample->velocity = NAN;
+            sample->tap_count = 0;
+            sample->cpr_good = false;
+            sample->gap = true;
+            gap_out = true;
+            return true;
+        }
+
+        float f = (float)(next_out - a.timestamp) / (float)(b.timestamp - a.timestamp);
+        *sample = a;
+        sample->timestamp = next_out;
+        sample->acl_x = a.acl_x + (b.acl_x - a.acl_x) * f;
+        sample->acl_y = a.acl_y + (b.acl_y - a.acl_y) * f;
+        sample->acl_z = a.acl_z + (b.acl_z - a.acl_z) * f;
+        sample->acl_len = a.acl_len + (b.acl_len - a.acl_len) * f;
+        sample->displacement = a.displacement + (b.displacement - a.displacement) * f;
+        sample->velocity = a.velocity + (b.velocity - a.velocity) * f;
+        next_out += period;
+        gap_out = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+#ifndef JITTERBUFFER_H
+#define JITTERBUFFER_H
+
+#include <stdint.h>
+
+#include "cprsample.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Holds one device's samples back by a fixed delay and plays them out
+// evenly spaced, for a live plot that scrolls smoothly however bursty
+// the network delivers them.
+//
+// pull() hands out samples on a uniform grid of the configured period up
+// to now - delay, each one linearly interpolated between the samples
+// around it; tap count and CPR flag are taken from the earlier one. Lost
+// data (a gap marker, or more than MaxGap periods without a sample) comes
+// out as a single gap marker, and the grid carries on after it.
+//
+// Samples come with distinct plot times: DevicePipeline places those of
+// v3 frames by the device clock and spreads the others evenly over the
+// time before their socket read, so bursts arrive here already spread. A
+// sample arriving after its time was played out is dropped.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class JitterBuffer
+{
+public:
+    static const int Capacity = 2048;   // must be a power of two
+    static const int MaxGap = 10;       // periods
+
+    void setDelay(int64_t nanoseconds) { delay = nanoseconds; }
+    void setPeriod(int64_t nanoseconds) { period = nanoseconds; }
+    int64_t delayTime() const { return delay; }
+
+    void push(const CprSample &sample);
+    bool pull(int64_t now, CprSample *sample);
+
+    uint64_t lateSamples() const { return late_samples; }
+    uint64_t overflowCount() const { return overflows; }
+
+private:
+    CprSample &at(int index) { return ring[(first + index) & (Capacity - 1)]; }
+    void dropFirst() { first = (first + 1) & (Capacity - 1); count--; }
+
+    CprSample ring[Capacity];
+    int first = 0;
+    int count = 0;
+
+    int64_t delay = 0;
+    int64_t period = 10000000;
+    bool started = false;
+    int64_t next_out = 0;           // grid time of the next sample pull() hands out
+    bool gap_out = false;           // the last one was a gap marker
+
+    uint64_t late_samples = 0;
+    uint64_t overflows = 0;
+};
+
+#endif // JITTERBUFFER_H
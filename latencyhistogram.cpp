@@ -0,0 +1,94 @@
+#include "latencyhistogram.h"
+
+#include <QtAlgorithms>
+
+#include <string.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Count one latency sample
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void LatencyHistogram::record(int64_t nanoseconds)
+{
+    if (nanoseconds < 0)            // clocks are monotonic, but stages may be skipped
+        nanoseconds = 0;
+    buckets[bucketOf(nanoseconds)]++;
+    total++;
+    if (nanoseconds > max_value)
+        max_value = nanoseconds;
+}
+
+void LatencyHistogram::add(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BucketCount; i++)
+        buckets[i] += other.buckets[i];
+    total += other.total;
+    if (other.max_value > max_value)
+        max_value = other.max_value;
+}
+
+void LatencyHistogram::reset()
+{
+    memset(buckets, 0, sizeof(buckets));
+    total = 0;
+    max_value = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Upper bound of the bucket holding the p-th percentile (p in 0..100)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int64_t LatencyHistogram::percentile(double p) const
+{
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(p / 100.0 * total + 0.5);
+    if (rank < 1)
+        rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BucketCount; i++) {
+        seen += buckets[i];
+        if (seen >= rank)
+            return upperBound(i) < max_value ? upperBound(i) : max_value;
+    }
+    return max_value;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Percentiles followed by every non-empty bucket, for dumping to a file
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+QString LatencyHistogram::toText() const
+{
+    QString text = QString("count %1  p50 %2 us  p90 %3 us  p99 %4 us  p99.9 %5 us  max %6 us\n")
+                   .arg(total)
+                   .arg(percentile(50) / 1.0e3, 0, 'f', 1)
+                   .arg(percentile(90) / 1.0e3, 0, 'f', 1)
+                   .arg(percentile(99) / 1.0e3, 0, 'f', 1)
+                   .arg(percentile(99.9) / 1.0e3, 0, 'f', 1)
+                   .arg(max_value / 1.0e3, 0, 'f', 1);
+    for (int i = 0; i < BucketCount; i++) {
+        if (buckets[i])
+            text += QString("  <= %1 us: %2\n").arg(upperBound(i) / 1.0e3, 0, 'f', 3).arg(buckets[i]);
+    }
+    return text;
+}
+
+int LatencyHistogram::bucketOf(int64_t value)
+{
+    if (value < SubBuckets)                     // first octaves are exact
+        return (int)value;
+
+    int exponent = 63 - (int)qCountLeadingZeroBits((quint64)value);
+    int mantissa = (int)((value >> (exponent - 3)) & (SubBuckets - 1));    // next 3 bits below the leading one
+    int bucket = (exponent - 2) * SubBuckets + mantissa;
+    return bucket < BucketCount ? bucket : BucketCount - 1;
+}
+
+int64_t LatencyHistogram::upperBound(int bucket)
+{
+    if (bucket < SubBuckets)
+        return bucket;
+
+    int exponent = bucket / SubBuckets + 2;
+    int mantissa = bucket % SubBuckets;
+    return ((int64_t)(SubBuckets + mantissa + 1) << (exponent - 3)) - 1;
+}
@@ -0,0 +1,42 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QString>
+
+#include <stdint.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Log-linear latency histogram.
+//
+// Every power of two (in nanoseconds) is split into 8 buckets, so
+// percentiles are accurate to within 12.5% from 1 ns up to several
+// minutes while record() stays a handful of integer operations.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class LatencyHistogram
+{
+public:
+    static const int SubBuckets = 8;
+    static const int BucketCount = 40 * SubBuckets;    // up to 2^40 ns
+
+    LatencyHistogram() { reset(); }
+
+    void record(int64_t nanoseconds);
+    void add(const LatencyHistogram &other);
+    void reset();
+
+    uint64_t count() const { return total; }
+    int64_t percentile(double p) const;
+    int64_t maximum() const { return max_value; }
+
+    QString toText() const;
+
+private:
+    static int bucketOf(int64_t value);
+    static int64_t upperBound(int bucket);
+
+    uint64_t buckets[BucketCount];
+    uint64_t total;
+    int64_t max_value;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,136 @@
+#include "latencymonitor.h"
+
+#include <QFile>
+#include <QTextStream>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// A sample left the queue: its ingestion stages are complete
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void LatencyMonitor::sampleDrained(const CprSample &sample)
+{
+    window[ReadToDecode].record(sample.decoded_at - sample.read_at);
+    window[DecodeToEnqueue].record(sample.enqueued_at - sample.decoded_at);
+    pending_read.append(sample.read_at);
+    pending_enqueued.append(sample.enqueued_at);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The samples drained since the last call were added to their graphs;
+// with several devices this happens once per device before one replot
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void LatencyMonitor::batchAdded(int64_t added_at)
+{
+    for (int i = pending_added.size(); i < pending_read.size(); i++) {
+        window[EnqueueToPlot].record(added_at - pending_enqueued[i]);
+        pending_added.append(added_at);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The replot showing every pending sample finished
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void LatencyMonitor::batchShown(int64_t shown_at)
+{
+    for (int i = 0; i < pending_added.size(); i++) {
+        window[PlotToShown].record(shown_at - pending_added[i]);
+        window[ReadToShown].record(shown_at - pending_read[i]);
+    }
+    pending_read.resize(0);            // keeps the allocation for the next frame
+    pending_enqueued.resize(0);
+    pending_added.resize(0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The pending samples will not be shown by a replot of their own - the
+// window is hidden or minimized. Forget them rather than charge the whole
+// time until the next replot to them.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void LatencyMonitor::batchDropped()
+{
+    pending_read.resize(0);
+    pending_enqueued.resize(0);
+    pending_added.resize(0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// One redraw, full or of the new strip only, including its paint
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void LatencyMonitor::frameRendered(int64_t nanoseconds, bool full)
+{
+    if (full)
+        full_redraws.record(nanoseconds);
+    else
+        strip_redraws.record(nanoseconds);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Start a new display window every WindowLength; true if one was closed
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool LatencyMonitor::rollWindow(int64_t now)
+{
+    if (window_start == 0)
+        window_start = now;
+    if (now - window_start < WindowLength)
+        return false;
+
+    for (int i = 0; i < StageCount; i++) {
+        total[i].add(window[i]);
+        last_window[i] = window[i];
+        window[i].reset();
+    }
+    window_start = now;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// p50/p99 of the last window in ms, for a label
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+QString LatencyMonitor::summary() const
+{
+    QString text = "Latency p50/p99 (ms):";
+    for (int i = 0; i < StageCount; i++) {
+        text += QString("  %1 %2/%3").arg(stageName(i))
+                .arg(last_window[i].percentile(50) / 1.0e6, 0, 'f', 2)
+                .arg(last_window[i].percentile(99) / 1.0e6, 0, 'f', 2);
+    }
+    return text;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Write the histograms of every stage since start to fileName
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool LatencyMonitor::dump(const QString &fileName, double replotTime, QString *errorString) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "redraw time: " << replotTime << " ms (smoothed)\n";
+    for (int i = 0; i < StageCount; i++) {
+        LatencyHistogram histogram = total[i];
+        histogram.add(window[i]);
+        out << "\n" << stageName(i) << ": " << histogram.toText();
+    }
+    out << "\nfull redraw: " << full_redraws.toText();
+    out << "\nstrip redraw: " << strip_redraws.toText();
+    return true;
+}
+
+const char *LatencyMonitor::stageName(int stage)
+{
+    switch (stage) {
+    case ReadToDecode:
+        return "decode";
+    case DecodeToEnqueue:
+        return "enqueue";
+    case EnqueueToPlot:
+        return "queue";
+    case PlotToShown:
+        return "replot";
+    default:
+        return "total";
+    }
+}
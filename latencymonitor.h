@@ -0,0 +1,62 @@
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QString>
+#include <QVector>
+
+#include <stdint.h>
+
+#include "cprsample.h"
+#include "latencyhistogram.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// End-to-end latency of plotted samples, from socket read to the end of
+// the replot that draws them, split into pipeline stages.
+//
+// Percentiles of the last completed window are meant for live display,
+// the totals since start can be dumped to a file. Redraw times, up to
+// the end of the paint that shows them, are kept apart for full replots
+// and for strip redraws, so the dump compares the two.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class LatencyMonitor
+{
+public:
+    enum Stage {
+        ReadToDecode,
+        DecodeToEnqueue,
+        EnqueueToPlot,          // time spent waiting in the queue for the GUI timer
+        PlotToShown,            // addData() and replot()
+        ReadToShown,
+        StageCount
+    };
+
+    static const int64_t WindowLength = 5000000000LL;  // ns
+
+    void sampleDrained(const CprSample &sample);
+    void batchAdded(int64_t added_at);
+    void batchShown(int64_t shown_at);
+    void batchDropped();
+    void frameRendered(int64_t nanoseconds, bool full);
+
+    int pendingSamples() const { return pending_read.size(); }     // drained, not shown yet
+
+    bool rollWindow(int64_t now);
+    QString summary() const;
+    bool dump(const QString &fileName, double replotTime, QString *errorString) const;
+
+private:
+    static const char *stageName(int stage);
+
+    QVector<int64_t> pending_read;      // stamps of samples added but not shown yet
+    QVector<int64_t> pending_enqueued;
+    QVector<int64_t> pending_added;
+
+    LatencyHistogram window[StageCount];
+    LatencyHistogram last_window[StageCount];
+    LatencyHistogram total[StageCount];
+    LatencyHistogram full_redraws;
+    LatencyHistogram strip_redraws;
+    int64_t window_start = 0;
+};
+
+#endif // LATENCYMONITOR_H
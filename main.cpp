@@ -1,11 +1,18 @@
+#include "appconfig.h"
+#include "headlessrunner.h"
 #include "mainwindow.h"
 #include "qcustomplot.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    if (isHeadless(argc, argv))         // no widgets at all, only the ingestion pipeline (also built alone as cprheadless)
+        return runHeadless(argc, argv);
+
     QApplication a(argc, argv);
-    MainWindow w;
+    AppConfig config;
+    parseCommandLine(a, &config);
+    MainWindow w(config);
     w.setWindowTitle("CPReader");
     w.resize(900,500);
     w.setWindowIcon(QIcon(":icons/cpr.png"));
@@ -1,66 +1,92 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "monotonicclock.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+#include <QtMath>
+
+static const double TimeWindow = 8.0;  // seconds shown in the live view
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 // Constructor
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-MainWindow::MainWindow(QWidget *parent) :
+MainWindow::MainWindow(const AppConfig &config, QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
-    socket = new QTcpSocket(this);
-
-    connect(this, &MainWindow::newMessage, this, &MainWindow::displayMessage);
-    connect(socket, &QTcpSocket::readyRead, this, &MainWindow::readSocket);
-    connect(socket, &QTcpSocket::disconnected, this, &MainWindow::discardSocket);
-
-    socket->connectToHost(QHostAddress("192.168.4.1"), 9000);
-
-    if (!socket->waitForConnected()){
-        QMessageBox::critical(this,"QTCPClient", QString("The following error occurred: %1.").arg(socket->errorString()));
-        exit(EXIT_FAILURE);
+    start_time = monotonicNanoseconds();
+    replaying = !config.replay_file.isEmpty();
+    replays_running = replaying ? config.devices.size() : 0;
+    jitter_delay = config.jitter_delay * 1000000LL;
+    full_redraw = config.full_redraw;
+
+    qRegisterMetaType<QAbstractSocket::SocketError>();
+
+    // socket I/O runs in one thread for all devices, decoding and tap metrics on the processing pool;
+    // samples come back through each device's pipeline
+    pool = new ProcessingPool(config.threads);
+    for (int i = 0; i < config.devices.size(); i++) {
+        Device *device = new Device;
+        device->name = QString("Device %1  %2:%3").arg(i + 1).arg(config.devices[i].address.toString()).arg(config.devices[i].port);
+        device->pipeline = new DevicePipeline(pool, start_time);
+        device->pipeline->setRecorder(&recorder, (uint16_t)i);
+        device->jitter.setDelay(jitter_delay);
+        device->jitter.setPeriod((int64_t)(1.0e9 / config.display_rate));
+        device->worker = new IngestionWorker(config.devices[i].address, config.devices[i].port, device->pipeline);
+        device->worker->setProtocol(config.protocol);
+        if (replaying)
+            device->worker->setReplay(config.replay_file, config.replay_speed, (uint16_t)i);
+        device->worker->moveToThread(&ingestionThread);
+
+        connect(&ingestionThread, &QThread::started, device->worker, &IngestionWorker::start);
+        connect(&ingestionThread, &QThread::finished, device->worker, &QObject::deleteLater);
+        connect(device->worker, &IngestionWorker::connectionFailed, this, &MainWindow::connectionFailed);
+        connect(device->worker, &IngestionWorker::connected, this, &MainWindow::deviceConnected);
+        connect(device->worker, &IngestionWorker::socketError, this, &MainWindow::displayError);
+        connect(device->worker, &IngestionWorker::replayFinished, this, &MainWindow::replayFinished);
+        devices.append(device);
     }
-    // Setting up plot module
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // accelerometer X component
-    ui->customplot->graph(0)->setPen(QPen(Qt::blue));
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // accelerometer Y component
-    ui->customplot->graph(1)->setPen(QPen(Qt::red));
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // accelerometer Z component
-    ui->customplot->graph(2)->setPen(QPen(Qt::darkGreen));
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // accelerometer vector length
-    ui->customplot->graph(3)->setPen(QPen(Qt::green));
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // displacement
-    ui->customplot->graph(4)->setPen(QPen(Qt::cyan));
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // velocity
-    ui->customplot->graph(5)->setPen(QPen(Qt::darkBlue));
-
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // Hidden graph; Represents tap count = 1
-    ui->customplot->graph(6)->setPen(QPen(Qt::transparent));
-    ui->customplot->graph(6)->setBrush(QBrush(QColor(147, 175, 250, 100)));
-    ui->customplot->addGraph(ui->customplot->xAxis, ui->customplot->yAxis); // Hidden graph; Represents tap count = 2
-    ui->customplot->graph(7)->setPen(QPen(Qt::transparent));
-    ui->customplot->graph(7)->setBrush(QBrush(QColor(147, 250, 194, 100)));
-
-    QSharedPointer<QCPAxisTickerTime> timeTicker(new QCPAxisTickerTime);
-    timeTicker->setTimeFormat("%h:%m:%s");
-    ui->customplot->xAxis->setTicker(timeTicker);
-    ui->customplot->axisRect()->setupFullAxesBox();
-    ui->customplot->yAxis->setRange(-1.0, 1.0);
-
-    connect(ui->customplot->xAxis, SIGNAL(rangeChanged(QCPRange)), ui->customplot->xAxis2, SLOT(setRange(QCPRange)));
-    connect(ui->customplot->yAxis, SIGNAL(rangeChanged(QCPRange)), ui->customplot->yAxis2, SLOT(setRange(QCPRange)));
 
-    ui->customplot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    // Setting up plot module: one axis rect per device in a grid, all redrawn by the same replot()
+    QCustomPlot *plot = ui->customplot;
+    plot->plotLayout()->clear();
+    QCPMarginGroup *margins = new QCPMarginGroup(plot);
+    int columns = qCeil(qSqrt(devices.size()));
+    for (int i = 0; i < devices.size(); i++) {
+        QCPLayoutGrid *cell = new QCPLayoutGrid;
+        plot->plotLayout()->addElement(i / columns, i % columns, cell);
+        setupDevicePlot(devices[i], cell, margins);
+    }
+    plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+
+    // grids and graphs scroll, so a frame only draws the new strip of data; the time axes get a buffer
+    // of their own, and the value axes, axis boxes and titles stay cached until a full replot
+    plot->setupStripChartLayers();
+    strip_layer = plot->layer("strip");
+    key_axes_layer = plot->layer("keyAxes");
+
+    // with several devices the rate and heart of each one are shown in its plot title instead
+    if (devices.size() > 1) {
+        ui->label->setVisible(false);
+        ui->label_2->setVisible(false);
+        ui->heart->setVisible(false);
+    }
 
-    QDataStream socketStream(socket);
-    socketStream.setVersion(QDataStream::Qt_5_12);
-    socketStream.setByteOrder(QDataStream::LittleEndian);
+    ingestionThread.start();
 
-    // setup a timer thatr repeatedly calls MainWindow::realtimeDataSlot:
+    // setup a timer that calls MainWindow::realtimeDataSlot once per display frame:
+    // it drains the queues every time, replots only when something changed
+    qreal refresh_rate = QGuiApplication::primaryScreen() ? QGuiApplication::primaryScreen()->refreshRate() : 60.0;
+    if (refresh_rate < 10.0)
+        refresh_rate = 60.0;
+    render.setFrameInterval((int64_t)(1.0e9 / refresh_rate));
+    tick_interval = qMax(1, qRound(1000.0 / refresh_rate));
     dataTimer = new QTimer(this);
+    dataTimer->setTimerType(Qt::PreciseTimer);
     connect(dataTimer, SIGNAL(timeout()), this, SLOT(realtimeDataSlot()));
-    dataTimer->start(10);
+    dataTimer->start(tick_interval);
 
     // connect button signals/slots
     connect(ui->stopButton, SIGNAL(clicked()), this, SLOT(stopTimer()));
@@ -72,11 +98,24 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->checkBox_disp, SIGNAL(clicked(bool)), this, SLOT(showWhichPlots(bool)));
     connect(ui->checkBox_vel, SIGNAL(clicked(bool)), this, SLOT(showWhichPlots(bool)));
     connect(ui->showRawInput, SIGNAL(clicked()), this, SLOT(showRawInput()));
+    connect(ui->recordButton, SIGNAL(toggled(bool)), this, SLOT(toggleRecording(bool)));
+    connect(ui->dumpLatencyButton, SIGNAL(clicked()), this, SLOT(dumpLatency()));
+
+    // raw input: a fixed ring of samples, formatted only for the rows on screen
+    raw_input = new RawInputModel(this);
+    ui->rawInputView->setModel(raw_input);
+    batch = new PlotBatch(start_time, &latency, raw_input);
+    ui->rawInputView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->rawInputView->verticalHeader()->setDefaultSectionSize(ui->rawInputView->fontMetrics().height() + 2);
+    ui->rawInputView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->rawInputView->setColumnHidden(RawInputModel::DeviceColumn, devices.size() == 1);
 
     // set initial states of visibility
-    ui->textBrowser_receivedMessages->setVisible(false);
-    ui->customplot->graph(3)->setVisible(false);
-    ui->customplot->graph(5)->setVisible(false);
+    ui->rawInputView->setVisible(false);
+    foreach (Device *device, devices) {
+        device->graphs[3]->setVisible(false);
+        device->graphs[5]->setVisible(false);
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -84,148 +123,361 @@ MainWindow::MainWindow(QWidget *parent) :
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 MainWindow::~MainWindow()
 {
-    if(socket->isOpen())
-        socket->close();
+    foreach (Device *device, devices)
+        QMetaObject::invokeMethod(device->worker, "stop", Qt::BlockingQueuedConnection);
+    ingestionThread.quit();
+    ingestionThread.wait();
+    pool->stop();                       // no pipeline may run once they are deleted
+    recorder.close();
+    foreach (Device *device, devices)
+        delete device->pipeline;
+    qDeleteAll(devices);
+    delete pool;
+    delete batch;
     delete ui;
     delete dataTimer;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-// Read TCP
+// Axis rect and graphs of one device, placed into its layout cell
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-void MainWindow::readSocket()
+void MainWindow::setupDevicePlot(Device *device, QCPLayoutGrid *cell, QCPMarginGroup *margins)
 {
-    QByteArray socket_buffer;
-
-    uint16_t displacement_raw = 0;
-    int16_t velocity_raw = 0;
-    socket_buffer = socket->readAll();
-    //qDebug() << socket_buffer;
-    QList<QByteArray> tempList = socket_buffer.split('\xAA');           // Split based on 1st header
-    tempList.removeFirst();
-    if (!tempList.isEmpty() && tempList[0].front() == '\x86') {         // If 2nd header present - packet is likely ok
-        if (tempList[0].length() == 14) {
-            if (tempList[0].back() == calculateChecksum(tempList[0])) {     // If checksum is correct - packet 100% ok
-                memcpy(&acl_raw, tempList[0].data() + 1, 6);
-                memcpy(&displacement_raw, tempList[0].data() + 7, 2);
-                memcpy(&velocity_raw, tempList[0].data() + 9, 2);
-                memcpy(&tap_count, tempList[0].data() + 11, 1);
-                memcpy(&cpr_good, tempList[0].data() + 12, 1);
-
-                acl_x = ((float)acl_raw.x / 1.0e4);
-                acl_y = ((float)acl_raw.y / 1.0e4);
-                acl_z = ((float)acl_raw.z / 1.0e4);
-                acl_len = sqrt((acl_x * acl_x) + (acl_y * acl_y) + (acl_z * acl_z));
-                displacement = (float)((float)displacement_raw / 1.0e4);
-                velocity = (float)((float)velocity_raw / 1.0e4);
-            }
-        }
+    QCustomPlot *plot = ui->customplot;
+
+    device->title = nullptr;
+    if (devices.size() > 1) {
+        device->title = new QCPTextElement(plot, device->name);
+        cell->addElement(0, 0, device->title);
+    }
+    device->axis_rect = new QCPAxisRect(plot);
+    cell->addElement(cell->rowCount(), 0, device->axis_rect);
+    device->axis_rect->setMarginGroup(QCP::msLeft | QCP::msRight, margins);
+
+    QCPAxis *x = device->axis_rect->axis(QCPAxis::atBottom);
+    QCPAxis *y = device->axis_rect->axis(QCPAxis::atLeft);
+    for (int i = 0; i < GraphCount; i++)
+        device->graphs[i] = plot->addGraph(x, y);
+
+    device->graphs[0]->setPen(QPen(Qt::blue));          // accelerometer X component
+    device->graphs[1]->setPen(QPen(Qt::red));           // accelerometer Y component
+    device->graphs[2]->setPen(QPen(Qt::darkGreen));     // accelerometer Z component
+    device->graphs[3]->setPen(QPen(Qt::green));         // accelerometer vector length
+    device->graphs[4]->setPen(QPen(Qt::cyan));          // displacement
+    device->graphs[5]->setPen(QPen(Qt::darkBlue));      // velocity
+
+    device->graphs[6]->setPen(QPen(Qt::transparent));   // Hidden graph; Represents tap count = 1
+    device->graphs[6]->setBrush(QBrush(QColor(147, 175, 250, 100)));
+    device->graphs[7]->setPen(QPen(Qt::transparent));   // Hidden graph; Represents tap count = 2
+    device->graphs[7]->setBrush(QBrush(QColor(147, 250, 194, 100)));
+
+    QSharedPointer<QCPAxisTickerTime> timeTicker(new QCPAxisTickerTime);
+    timeTicker->setTimeFormat("%h:%m:%s");
+    x->setTicker(timeTicker);
+    device->axis_rect->setupFullAxesBox(true);
+    y->setRange(-1.0, 1.0);
+
+    // fixed size ring storage makes appends and trimming constant time; sized well above the retention window,
+    // a bit tighter with many devices so 16 of them stay within a few tens of MB
+    int capacity = devices.size() > 4 ? 1 << 14 : 1 << 16;
+    for (int i = 0; i < GraphCount; i++)
+        device->graphs[i]->data()->setRingCapacity(capacity);
+
+    // the view shows the last 8 seconds, keep a bit more to drag back through
+    device->retention.setTimeWindow(30.0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Show the last TimeWindow seconds up to key. While the range keeps its
+// size it only moves by whole pixels, so the strip layer can shift what
+// it drew instead of drawing it again.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void MainWindow::scrollKeyAxis(QCPAxis *axis, double key)
+{
+    QCPRange range = axis->range();
+    double lower = key - TimeWindow;
+    int width = axis->axisRect()->width();
+
+    if (width > 0 && qFuzzyCompare(range.size(), TimeWindow) && lower > range.lower) {
+        double per_pixel = TimeWindow / width;
+        lower = range.lower + qFloor((lower - range.lower) / per_pixel) * per_pixel;
     }
+    axis->setRange(lower, lower + TimeWindow);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Widest tick label of a device's time axis as laid out now
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int MainWindow::timeLabelWidth(const Device *device) const
+{
+    QCPAxis *axis = device->axis_rect->axis(QCPAxis::atBottom);
+    QFontMetrics metrics(axis->tickLabelFont());
+    int widest = 0;
+    foreach (const QString &label, axis->tickVectorLabels())
+        widest = qMax(widest, metrics.boundingRect(label).width());
+    return widest;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Plot title of a device: name, link state, tap rate and heart; true if
+// it changed and needs a replot
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool MainWindow::updateTitle(Device *device)
+{
+    QString text = device->name;
+    if (!replaying && !device->worker->link()->isConnected())
+        text += "  - connecting";
+    else
+        text += QString("  Tap/Minute: %1  ").arg(device->pipeline->tapsPerMinute()) + QChar(0x2665);
+    if (device->pipeline->qualityScore() >= 0)
+        text += QString("  Score: %1").arg(device->pipeline->qualityScore());
+
+    QColor color = device->pipeline->cprGood() ? Qt::red : Qt::darkGray;
+    if (text == device->title->text() && color == device->title->textColor())
+        return false;
+    device->title->setText(text);
+    device->title->setTextColor(color);
+    return true;
+}
 
-    socket_buffer.clear();
-    QString message = QString("x: %1 y: %2 z: %3").arg(acl_x).arg(acl_y).arg(acl_z);
-    emit newMessage(message);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Recorded session could not be opened
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void MainWindow::connectionFailed(const QString &errorString)
+{
+    QMessageBox::critical(this,"QTCPClient", QString("The following error occurred: %1.").arg(errorString));
+    exit(EXIT_FAILURE);
+}
+
+void MainWindow::deviceConnected()
+{
+    foreach (Device *device, devices) {
+        if (device->worker == sender())
+            device->link_message.clear();
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-// Disconnect case
+// One device's file is fed; updateStatus() reports once all are decoded
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-void MainWindow::discardSocket()
+void MainWindow::replayFinished(quint64 frames, qint64 nanoseconds)
 {
-    socket->deleteLater();
-    socket=nullptr;
+    Q_UNUSED(frames);
+    replay_time = qMax(replay_time, (int64_t)nanoseconds);
+    replays_running--;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-// Display TCP errors
+// Decode throughput of the replay from the time the pool spent in the
+// pipelines; unthrottled replay is paced by the drain and the replots,
+// so the wall time says nothing about decoding
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-void MainWindow::displayError(QAbstractSocket::SocketError socketError)
+void MainWindow::reportReplay()
 {
+    uint64_t frames = 0;
+    int64_t busy = 0;
+    foreach (Device *device, devices) {
+        frames += device->pipeline->decodedFrames();
+        busy += device->pipeline->busyTime();
+    }
+
+    double seconds = busy / 1.0e9;
+    replay_message = QString("Replay: %1 frames decoded in %2 s of pool time (%3 frames/s), fed in %4 s")
+                     .arg(frames)
+                     .arg(seconds, 0, 'f', 3)
+                     .arg(seconds > 0.0 ? frames / seconds : 0.0, 0, 'f', 0)
+                     .arg(replay_time / 1.0e9, 0, 'f', 3);
+    qInfo().noquote() << replay_message;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Display TCP errors - in the status bar, the worker keeps reconnecting
+// and a message box per attempt would bury the window
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void MainWindow::displayError(QAbstractSocket::SocketError socketError, const QString &errorString)
+{
+    QString message;
     switch (socketError) {
         case QAbstractSocket::RemoteHostClosedError:
+            message = "The manikin closed the connection.";
         break;
         case QAbstractSocket::HostNotFoundError:
-            QMessageBox::information(this, "QTCPClient", "The host was not found. Please check the host name and port settings.");
+            message = "The host was not found. Please check the host name and port settings.";
         break;
         case QAbstractSocket::ConnectionRefusedError:
-            QMessageBox::information(this, "QTCPClient", "The connection was refused by the peer. Make sure QTCPServer is running, and check that the host name and port settings are correct.");
+            message = "The connection was refused by the peer. Make sure the manikin is on, and check that the host name and port settings are correct.";
         break;
         default:
-            QMessageBox::information(this, "QTCPClient", QString("The following error occurred: %1.").arg(socket->errorString()));
+            message = QString("The following error occurred: %1.").arg(errorString);
         break;
     }
+
+    foreach (Device *device, devices) {
+        if (device->worker == sender())
+            device->link_message = message;
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-// Plot update
+// Plot update - all devices, one replot if anything changed
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 void MainWindow::realtimeDataSlot()
 {
-    static QTime time(QTime::currentTime());
-    // calculate two new data points:
-    double key = time.elapsed()/1000.0; // time elapsed since start of demo, in seconds
-    static double lastPointKey = 0;
-
-    //::::::::::::::::::: Add points to graphs :::::::::::::::::::::::::::
-    if (key-lastPointKey > 0.01) // at most add point every 1 ms
-    {
-      // add data to lines:
-      ui->customplot->graph(0)->addData(key, acl_x);
-      ui->customplot->graph(1)->addData(key, acl_y);
-      ui->customplot->graph(2)->addData(key, acl_z);
-      ui->customplot->graph(3)->addData(key, acl_len);
-      ui->customplot->graph(4)->addData(key, displacement);
-      ui->customplot->graph(5)->addData(key, velocity);
-      switch (tap_count) {
-      case 1:
-          ui->customplot->graph(6)->addData(key, 5);
-          ui->customplot->graph(7)->addData(key, 0);
-          break;
-      case 2:
-          ui->customplot->graph(7)->addData(key, 5);
-          ui->customplot->graph(6)->addData(key, 0);
-          break;
-      default:
-          ui->customplot->graph(6)->addData(key, 0);
-          ui->customplot->graph(7)->addData(key, 0);
-          break;
-      }
-      lastPointKey = key;
-    }
-
-    // make key axis range scroll with the data (at a constant range size of 8):
-    ui->customplot->xAxis->setRange(key, 8, Qt::AlignRight);
+    int64_t now = monotonicNanoseconds();
+    double key = (now - jitter_delay - start_time) / 1.0e9; // time elapsed since start, in seconds, as far as it is plotted
+
+    foreach (Device *device, devices) {
+        batch->drain(devices.indexOf(device) + 1, device->pipeline, jitter_delay > 0 ? &device->jitter : nullptr);
+
+        //::::::::::::::::::: Add points to graphs :::::::::::::::::::::::::::
+        if (!batch->isEmpty()) {
+            latency.batchAdded(monotonicNanoseconds());
+            for (int i = 0; i < GraphCount; i++) {
+                device->graphs[i]->data()->add(batch->points(i), true);    // a plain copy into the ring, unlike addData(keys, values)
+                device->retention.apply(device->graphs[i]);
+            }
 
-    static double perSecondKey;
-    static double perMinuteKey;
-    ui->label->setText(QString("Tap/Second: %1").arg(tap_count));
+            // make key axis range scroll with the data:
+            scrollKeyAxis(device->axis_rect->axis(QCPAxis::atBottom), key);
+            render.markDirty();
+        }
+    }
 
-    if (cpr_good) {
-        ui->heart->setEnabled(true);
-    } else {
-        ui->heart->setEnabled(false);
+    if (!isVisible() || isMinimized()) {
+        latency.batchDropped();         // nothing to draw into; the queues above are drained all the same
+        return;
     }
 
-    if (key - perSecondKey >= 1) {     // how many taps we made for this second
-        inner_tap_count = inner_tap_count + tap_count;
-        perSecondKey = key;
+    if (now - status_updated >= StatusInterval) {
+        updateStatus();
+        status_updated = now;
     }
-    if (key - perMinuteKey > 15) {   // every 15 seconds we can estimate taps per minute
-      ui->label_2->setText(QString("Tap/Minute: %1").arg(inner_tap_count * 4));
-      inner_tap_count = 0;
-      perMinuteKey = key;
+    if (ui->rawInputView->isVisible())
+        raw_input->publish();
+
+    if (!render.isDue(now))
+        return;
+
+    // redraw: everything after a title changed, otherwise only what moves - the time axes and the new data
+    int64_t started = monotonicNanoseconds();
+    bool full = chrome_dirty || full_redraw;
+    if (full) {
+        if (full_redraw)
+            strip_layer->invalidateScroll();
+        ui->customplot->replot();
+        chrome_dirty = false;
+        foreach (Device *device, devices)
+            device->time_label_width = timeLabelWidth(device);
+    } else {
+        key_axes_layer->replot();       // falls back to a full replot if the layers were rearranged
+        strip_layer->replot();
+        foreach (Device *device, devices) {
+            if (timeLabelWidth(device) != device->time_label_width) {
+                chrome_dirty = true;    // the axis layout may have to change, next frame redraws everything
+                render.markDirty();
+            }
+        }
     }
-
-    // redraw
-    ui->customplot->replot();
+    ui->customplot->repaint();          // composite the buffers now rather than in a later paint event, and time it
+
+    int64_t shown = monotonicNanoseconds();
+    render.rendered(shown, (shown - started) / 1.0e6);
+    latency.frameRendered(shown - started, full);
+    latency.batchShown(shown);
+    if (latency.rollWindow(shown))
+        ui->label_latency->setText(latency.summary());
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-// Update raw data window
+// Counters, rates and link state in the labels, status bar and titles
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
-void MainWindow::displayMessage(const QString& str)
+void MainWindow::updateStatus()
 {
-    ui->textBrowser_receivedMessages->append(str);
+    uint64_t frames = 0, resyncs = 0, checksum_errors = 0, overflows = 0;
+    uint64_t lost = 0, duplicates = 0, reordered = 0, late = 0;
+    int links_up = 0;
+    int protocol = FrameDecoder::MaxVersion;    // the weakest check in use
+    QString link_message;
+
+    foreach (Device *device, devices) {
+        if (device->title && updateTitle(device)) {
+            chrome_dirty = true;        // titles are in the cached layers
+            render.markDirty();
+        }
+
+        frames += device->pipeline->decodedFrames();
+        resyncs += device->pipeline->resyncCount();
+        checksum_errors += device->pipeline->checksumErrors();
+        overflows += device->pipeline->inputOverflows() + device->pipeline->sampleOverflows();
+        protocol = qMin(protocol, device->pipeline->protocolVersion());
+        lost += device->pipeline->lostSamples();
+        duplicates += device->pipeline->duplicateFrames();
+        reordered += device->pipeline->reorderedFrames();
+        late += device->jitter.lateSamples();
+        if (device->worker->link()->isConnected())
+            links_up++;
+        else if (link_message.isEmpty() && !device->link_message.isEmpty())
+            link_message = device->name + ": " + device->link_message;
+    }
+
+    if (replaying && replays_running == 0 && replay_message.isEmpty()) {
+        bool decoded = true;
+        foreach (Device *device, devices)
+            decoded = decoded && device->pipeline->isIdle();
+        if (decoded)
+            reportReplay();
+    }
+
+    const DevicePipeline *first = devices.first()->pipeline;
+    ui->label->setText(QString("Tap/Second: %1").arg(first->tapsPerSecond()));
+    ui->label_2->setText(QString("Tap/Minute: %1").arg(first->tapsPerMinute()));
+
+    if (first->cprGood()) {
+        ui->heart->setEnabled(true);
+    } else {
+        ui->heart->setEnabled(false);
+    }
+
+    QString status = QString("Frames: %1  Resyncs: %2  Checksum errors: %3  Queue overflows: %4  Protocol: v%5")
+                     .arg(frames)
+                     .arg(resyncs)
+                     .arg(checksum_errors)
+                     .arg(overflows)
+                     .arg(protocol);
+    if (protocol >= 3)                          // sequence numbered frames
+        status += QString("  Lost samples: %1  Duplicates: %2  Reordered: %3").arg(lost).arg(duplicates).arg(reordered);
+    if (devices.size() == 1 && first->qualityScore() >= 0)     // several devices show it in their titles
+        status += QString("  Rate: %1/min  Depth: %2 mm  Recoil: %3  Duty: %4%  Score: %5")
+                  .arg(first->compressionRate())
+                  .arg(first->compressionDepth())
+                  .arg(first->fullRecoil() ? "full" : "incomplete")
+                  .arg(first->dutyCycle())
+                  .arg(first->qualityScore());
+    if (jitter_delay > 0)
+        status += QString("  Jitter delay: %1 ms  Late: %2").arg(jitter_delay / 1000000).arg(late);
+    if (!replaying) {
+        if (devices.size() > 1) {
+            status += QString("  Connected: %1/%2").arg(links_up).arg(devices.size());
+        } else {
+            const ConnectionManager *link = devices.first()->worker->link();
+            if (link->isConnected())
+                status += QString("  Connected in %1 ms").arg(link->lastConnectTime() / 1.0e6, 0, 'f', 1);
+            else
+                status += QString("  Connecting (attempt %1)").arg(link->connectAttempts());
+            status += QString("  Reconnects: %1  Downtime: %2 s")
+                      .arg(link->reconnects())
+                      .arg(link->downtime(monotonicNanoseconds()) / 1.0e9, 0, 'f', 1);
+        }
+        if (!link_message.isEmpty())
+            status += "  " + link_message;
+    }
+    if (recorder.isRecording())
+        status += QString("  Recorded: %1  Dropped: %2").arg(recorder.recordsWritten()).arg(recorder.droppedRecords());
+    if (!replay_message.isEmpty())
+        status += "  " + replay_message;
+    if (render.renderInterval() > render.frameInterval())     // backed off, replots are slow
+        status += QString("  Redraw every %1 ms").arg(render.renderInterval() / 1000000);
+    statusBar()->showMessage(status);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -241,7 +493,7 @@ void MainWindow::stopTimer()
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 void MainWindow::resumeTimer()
 {
-    dataTimer->start(10);
+    dataTimer->start(tick_interval);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -249,43 +501,26 @@ void MainWindow::resumeTimer()
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 void MainWindow::showWhichPlots(bool checked)
 {
-    if (QObject::sender() == ui->checkBox_ax) {
-        if (checked)
-            ui->customplot->graph(0)->setVisible(true);
-        else
-            ui->customplot->graph(0)->setVisible(false);
+    int graph = -1;
+    if (QObject::sender() == ui->checkBox_ax)
+        graph = 0;
+    else if (QObject::sender() == ui->checkBox_ay)
+        graph = 1;
+    else if (QObject::sender() == ui->checkBox_az)
+        graph = 2;
+    else if (QObject::sender() == ui->checkBox_alen)
+        graph = 3;
+    else if (QObject::sender() == ui->checkBox_disp)
+        graph = 4;
+    else if (QObject::sender() == ui->checkBox_vel)
+        graph = 5;
+
+    if (graph >= 0) {
+        foreach (Device *device, devices)
+            device->graphs[graph]->setVisible(checked);
     }
-    else if (QObject::sender() == ui->checkBox_ay) {
-        if (checked)
-            ui->customplot->graph(1)->setVisible(true);
-        else
-            ui->customplot->graph(1)->setVisible(false);
-    }
-    else if (QObject::sender() == ui->checkBox_az) {
-        if (checked)
-            ui->customplot->graph(2)->setVisible(true);
-        else
-            ui->customplot->graph(2)->setVisible(false);
-    }
-    else if (QObject::sender() == ui->checkBox_alen) {
-        if (checked)
-            ui->customplot->graph(3)->setVisible(true);
-        else
-            ui->customplot->graph(3)->setVisible(false);
-    }
-    else if (QObject::sender() == ui->checkBox_disp) {
-        if (checked)
-            ui->customplot->graph(4)->setVisible(true);
-        else
-            ui->customplot->graph(4)->setVisible(false);
-    }
-    else if (QObject::sender() == ui->checkBox_vel) {
-        if (checked)
-            ui->customplot->graph(5)->setVisible(true);
-        else
-            ui->customplot->graph(5)->setVisible(false);
-    }
-    ui->customplot->replot();
+    strip_layer->invalidateScroll();   // the shown part of the graph is not drawn yet
+    render.markDirty();                 // drawn with the next frame
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -293,17 +528,48 @@ void MainWindow::showWhichPlots(bool checked)
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 void MainWindow::showRawInput()
 {
-    if (!ui->textBrowser_receivedMessages->isVisible())
-        ui->textBrowser_receivedMessages->setVisible(true);
-    else if (ui->textBrowser_receivedMessages->isVisible())
-        ui->textBrowser_receivedMessages->setVisible(false);
+    if (!ui->rawInputView->isVisible()) {
+        raw_input->publish();           // catch up with what arrived while hidden
+        ui->rawInputView->setVisible(true);
+    } else {
+        ui->rawInputView->setVisible(false);
+    }
 }
 
-char MainWindow::calculateChecksum(const QByteArray &buff)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Record button handle
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void MainWindow::toggleRecording(bool checked)
+{
+    if (!checked) {
+        recorder.close();
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Record session",
+                                                    QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+                                                    "CPR sessions (*.cprs)");
+    if (fileName.isEmpty() || !recorder.open(fileName)) {
+        if (!fileName.isEmpty())
+            QMessageBox::critical(this, "QTCPClient", QString("Could not record to %1: %2.").arg(fileName).arg(recorder.errorString()));
+        ui->recordButton->blockSignals(true);
+        ui->recordButton->setChecked(false);
+        ui->recordButton->blockSignals(false);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Dump latency button handle
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void MainWindow::dumpLatency()
 {
-    unsigned char checksum = 0;
-    int16_t buff_len = buff.length();
-    for (int i = 1; i < buff_len - 1; i++)  // start from 1 - ignoring the header
-        checksum = checksum ^ buff.at(i);
-    return checksum;
+    QString fileName = QFileDialog::getSaveFileName(this, "Dump latency histograms",
+                                                    QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/latency.txt",
+                                                    "Text files (*.txt)");
+    if (fileName.isEmpty())
+        return;
+
+    QString errorString;
+    if (!latency.dump(fileName, render.renderTime(), &errorString))
+        QMessageBox::critical(this, "QTCPClient", QString("Could not write %1: %2.").arg(fileName).arg(errorString));
 }
@@ -7,11 +7,27 @@
 #include <QFile>
 #include <QFileDialog>
 #include <QHostAddress>
+#include <QList>
 #include <QMessageBox>
 #include <QMetaType>
 #include <QString>
 #include <QStandardPaths>
-#include <QTcpSocket>
+#include <QThread>
+#include <QVector>
+
+#include "appconfig.h"
+#include "cprsample.h"
+#include "devicepipeline.h"
+#include "ingestionworker.h"
+#include "jitterbuffer.h"
+#include "latencymonitor.h"
+#include "plotbatch.h"
+#include "plotretention.h"
+#include "processingpool.h"
+#include "qcustomplot.h"
+#include "rawinputmodel.h"
+#include "renderscheduler.h"
+#include "sessionrecorder.h"
 
 namespace Ui {
 class MainWindow;
@@ -22,52 +38,78 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    explicit MainWindow(QWidget *parent = nullptr);
+    explicit MainWindow(const AppConfig &config, QWidget *parent = nullptr);
     ~MainWindow();
-signals:
-    void newMessage(QString);
 private slots:
-    void readSocket();
-    void discardSocket();
-    void displayError(QAbstractSocket::SocketError socketError);
+    void connectionFailed(const QString &errorString);
+    void deviceConnected();
+    void replayFinished(quint64 frames, qint64 nanoseconds);
+    void displayError(QAbstractSocket::SocketError socketError, const QString &errorString);
     void realtimeDataSlot();
     void stopTimer();
     void resumeTimer();
     void showWhichPlots(bool);
     void showRawInput();
-
-    void displayMessage(const QString& str);
+    void toggleRecording(bool checked);
+    void dumpLatency();
 private:
-    char calculateChecksum(const QByteArray &b);
+    static const int GraphCount = PlotBatch::GraphCount;
+    static const int64_t StatusInterval = 250000000;   // ns between status bar and title updates
+
+    // One manikin: its socket worker and processing pipeline, drawn into
+    // its own axis rect of the shared plot
+    struct Device {
+        IngestionWorker* worker;
+        DevicePipeline* pipeline;
+        QString name;
+        QString link_message;       // last socket error, shown while disconnected
+
+        QCPAxisRect* axis_rect;
+        QCPTextElement* title;      // name, rate and heart; only with several devices
+        QCPGraph* graphs[GraphCount];
+
+        JitterBuffer jitter;        // only with a jitter delay
+        PlotRetention retention;    // how much of its graphs is kept
+        int time_label_width = -1;  // px, widest time axis label at the last full replot
+    };
+
+    void setupDevicePlot(Device *device, QCPLayoutGrid *cell, QCPMarginGroup *margins);
+    void scrollKeyAxis(QCPAxis *axis, double key);
+    int timeLabelWidth(const Device *device) const;
+    void updateStatus();
+    void reportReplay();
+    bool updateTitle(Device *device);
 
     Ui::MainWindow *ui;
 
-    QTcpSocket* socket;
+    ProcessingPool* pool;
+    QThread ingestionThread;
+    QList<Device*> devices;
+    SessionRecorder recorder;
+    QString replay_message;
+    bool replaying = false;
+    int replays_running = 0;        // devices still feeding their file
+    int64_t replay_time = 0;        // ns until the last one was fed
+    int64_t start_time;
+    int64_t jitter_delay;           // ns, 0 plots samples as they arrive
+
+    PlotBatch* batch;               // samples drained during one timer tick, added in one go per graph
+
+    QCPLayer* strip_layer;          // grids and graphs, scrolled instead of redrawn
+    QCPLayer* key_axes_layer;       // time axes, redrawn every frame
+    bool chrome_dirty = true;       // cached layers need a full replot
+    bool full_redraw = false;       // never scroll, for comparing redraw times
+    RawInputModel* raw_input;
+    LatencyMonitor latency;
+    RenderScheduler render;
     QTimer* dataTimer;
+    int tick_interval;              // ms, one display frame
+    int64_t status_updated = 0;
 
     bool display_ax = true;
     bool display_ay = true;
     bool display_az = true;
     bool display_alen = true;
-
-    float acl_x = 0.0f;
-    float acl_y = 0.0f;
-    float acl_z = 0.0f;
-    float acl_len = 0.0f;
-
-    float displacement;
-    float velocity;
-
-    uint8_t tap_count = 0;
-    bool cpr_good = false;
-    uint8_t inner_tap_count = 0;
-
-    typedef struct {
-        int16_t x;
-        int16_t y;
-        int16_t z;
-    } acl_raw_t;
-    acl_raw_t acl_raw;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,13 @@
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include <chrono>
+#include <stdint.h>
+
+// Nanoseconds on a steady clock shared by all threads; never wraps or jumps
+inline int64_t monotonicNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // MONOTONICCLOCK_H
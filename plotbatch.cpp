@@ -0,0 +1,65 @@
+#include "plotbatch.h"
+#include "monotonicclock.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+PlotBatch::PlotBatch(int64_t start_time, LatencyMonitor *latency, RawInputModel *raw_input) :
+    start_time(start_time),
+    latency(latency),
+    raw_input(raw_input)
+{
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Drain samples decoded by one device's pipeline
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void PlotBatch::drain(int device, DevicePipeline *pipeline, JitterBuffer *jitter)
+{
+    CprSample sample;
+
+    for (int i = 0; i < GraphCount; i++)
+        graph_points[i].resize(0);      // keeps the allocation for the next drain
+
+    while (pipeline->samples().pop(&sample)) {
+        // with a jitter buffer samples are plotted evenly spaced once their time comes,
+        // otherwise each one at its own timestamp right away
+        if (jitter)
+            jitter->push(sample);
+        else
+            add(sample);
+
+        if (!sample.gap)
+            raw_input->append(device, sample);
+    }
+
+    if (jitter) {
+        int64_t now = monotonicNanoseconds();
+        while (jitter->pull(now, &sample))
+            add(sample);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Append one sample to the points of every graph
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void PlotBatch::add(const CprSample &sample)
+{
+    double key = (sample.timestamp - start_time) / 1.0e9;
+
+    if (sample.gap) {                   // lost data - a NaN point breaks every line
+        for (int i = 0; i < GraphCount; i++)
+            graph_points[i].append(QCPGraphData(key, qQNaN()));
+        return;
+    }
+
+    latency->sampleDrained(sample);
+    graph_points[0].append(QCPGraphData(key, sample.acl_x));
+    graph_points[1].append(QCPGraphData(key, sample.acl_y));
+    graph_points[2].append(QCPGraphData(key, sample.acl_z));
+    graph_points[3].append(QCPGraphData(key, sample.acl_len));
+    graph_points[4].append(QCPGraphData(key, sample.displacement));
+    graph_points[5].append(QCPGraphData(key, sample.velocity));
+    graph_points[6].append(QCPGraphData(key, sample.tap_count == 1 ? 5 : 0));
+    graph_points[7].append(QCPGraphData(key, sample.tap_count == 2 ? 5 : 0));
+}
@@ -0,0 +1,48 @@
+#ifndef PLOTBATCH_H
+#define PLOTBATCH_H
+
+#include <QVector>
+
+#include <stdint.h>
+
+#include "cprsample.h"
+#include "devicepipeline.h"
+#include "jitterbuffer.h"
+#include "latencymonitor.h"
+#include "qcustomplot.h"
+#include "rawinputmodel.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The points one plot update adds to a device's graphs.
+//
+// drain() takes everything the device's pipeline decoded since the last
+// update - or, with a jitter buffer, what it plays out by now - and turns
+// it into one vector per graph, so each goes into its data container with
+// a single add(). Lost data is a NaN point in every graph. The vectors
+// keep their allocation from one drain to the next, so once they have
+// grown to the largest batch draining allocates nothing.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class PlotBatch
+{
+public:
+    static const int GraphCount = 8;    // acl x, y, z, length, displacement, velocity, single tap, double tap
+
+    // Plot keys are seconds since start_time; every drained sample is passed to latency and raw_input
+    PlotBatch(int64_t start_time, LatencyMonitor *latency, RawInputModel *raw_input);
+
+    // device is the 1 based number shown in the raw input view; jitter is null to plot samples as they arrive
+    void drain(int device, DevicePipeline *pipeline, JitterBuffer *jitter);
+
+    bool isEmpty() const { return graph_points[0].isEmpty(); }
+    const QVector<QCPGraphData> &points(int graph) const { return graph_points[graph]; }
+
+private:
+    void add(const CprSample &sample);
+
+    int64_t start_time;
+    LatencyMonitor *latency;
+    RawInputModel *raw_input;
+    QVector<QCPGraphData> graph_points[GraphCount];
+};
+
+#endif // PLOTBATCH_H
@@ -0,0 +1,67 @@
+#include "plotretention.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Policy setters
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void PlotRetention::setTimeWindow(double seconds)
+{
+    retention_mode = TimeWindow;
+    time_window = seconds;
+}
+
+void PlotRetention::setPointBudget(int points)
+{
+    retention_mode = PointBudget;
+    point_budget = points;
+}
+
+void PlotRetention::setKeepAll()
+{
+    retention_mode = KeepAll;
+}
+
+void PlotRetention::setSlack(double fraction)
+{
+    slack = qMax(0.0, fraction);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Trim graph data that fell out of the retention limit
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void PlotRetention::apply(QCPGraph *graph) const
+{
+    QSharedPointer<QCPGraphDataContainer> data = graph->data();
+    if (data->isEmpty())
+        return;
+
+    switch (retention_mode) {
+    case TimeWindow: {
+        double newest = (data->constEnd() - 1)->key;
+        double cutoff = newest - time_window;
+        if (data->constBegin()->key < cutoff - time_window * slack)
+            trim(data.data(), cutoff);
+        break;
+    }
+    case PointBudget:
+        if (data->size() > point_budget + (int)(point_budget * slack))
+            trim(data.data(), data->at(data->size() - point_budget)->key);
+        break;
+    default:
+        break;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Remove everything keyed before cut. Points sharing one key stay or go
+// together, so a point budget may keep a few more than the budget.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void PlotRetention::trim(QCPGraphDataContainer *data, double cut)
+{
+    QCPGraphDataContainer::const_iterator first_kept = data->findBegin(cut, false);
+    if (first_kept == data->constBegin())
+        return;
+    if (first_kept == data->constEnd())
+        data->clear();
+    else
+        data->removeBefore(first_kept->key);
+}
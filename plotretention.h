@@ -0,0 +1,47 @@
+#ifndef PLOTRETENTION_H
+#define PLOTRETENTION_H
+
+#include "qcustomplot.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Keeps live graphs bounded, either to the last N seconds or to the last
+// N points. Trimming happens in batches: data is only removed once it
+// exceeds the limit by the slack fraction, so removeBefore() runs every
+// few seconds instead of on every timer tick.
+//
+// One instance is one policy; each plot holds its own and applies it to
+// its graphs. Trimmed data is dropped - the session recording, not the
+// plot, is the archive.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class PlotRetention
+{
+public:
+    enum Mode {
+        KeepAll,
+        TimeWindow,
+        PointBudget
+    };
+
+    PlotRetention() {}
+
+    void setTimeWindow(double seconds);
+    void setPointBudget(int points);
+    void setKeepAll();
+    void setSlack(double fraction);
+
+    Mode mode() const { return retention_mode; }
+    double timeWindow() const { return time_window; }
+    int pointBudget() const { return point_budget; }
+
+    void apply(QCPGraph *graph) const;
+
+private:
+    static void trim(QCPGraphDataContainer *data, double cut);
+
+    Mode retention_mode = KeepAll;
+    double time_window = 0.0;
+    int point_budget = 0;
+    double slack = 0.1;
+};
+
+#endif // PLOTRETENTION_H
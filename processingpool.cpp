@@ -0,0 +1,134 @@
+#include "processingpool.h"
+
+#include <QMutexLocker>
+
+static thread_local QThread *current_worker = nullptr;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor - starts the worker threads
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+ProcessingPool::ProcessingPool(int threads)
+{
+    if (threads <= 0)
+        threads = qMax(1, QThread::idealThreadCount());
+
+    for (int i = 0; i < threads; i++)
+        workers.append(new Worker(this, i));
+    foreach (Worker *worker, workers)
+        worker->start();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Destructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+ProcessingPool::~ProcessingPool()
+{
+    stop();
+    qDeleteAll(workers);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Wake every worker and wait for them to leave; a running task finishes
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ProcessingPool::stop()
+{
+    {
+        QMutexLocker lock(&idle_mutex);
+        stopping.store(true);
+        idle.wakeAll();
+    }
+    foreach (Worker *worker, workers)
+        worker->wait();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Queue a task and wake a sleeping worker if there is one
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ProcessingPool::schedule(PoolTask *task)
+{
+    Worker *worker = static_cast<Worker*>(current_worker);
+    if (!worker || worker->pool != this) {
+        if (task->home < 0)
+            task->home = (int)(next_home.fetch_add(1, std::memory_order_relaxed) % (uint32_t)workers.size());
+        worker = workers[task->home];
+    }
+    bool pushed = push(worker, task);
+    for (int i = 1; !pushed && i < workers.size(); i++)
+        pushed = push(workers[(worker->index + i) % workers.size()], task);
+    if (!pushed) {
+        task->run();                    // every deque is full - nothing may be dropped, so run it here
+        tasks_run.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // pairs with the check in Worker::run() - either the worker sees the new task or we see it sleeping
+    queued.fetch_add(1);
+    if (sleeping.load() > 0) {
+        QMutexLocker lock(&idle_mutex);
+        idle.wakeOne();
+    }
+}
+
+bool ProcessingPool::push(Worker *worker, PoolTask *task)
+{
+    QMutexLocker lock(&worker->mutex);
+    if (worker->count == TaskCapacity)
+        return false;
+    worker->tasks[(worker->front + worker->count) & (TaskCapacity - 1)] = task;
+    worker->count++;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Newest task of our own deque, or the oldest one of somebody else's
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+PoolTask *ProcessingPool::take(int index)
+{
+    Worker *own = workers[index];
+    {
+        QMutexLocker lock(&own->mutex);
+        if (own->count > 0) {
+            own->count--;
+            return own->tasks[(own->front + own->count) & (TaskCapacity - 1)];
+        }
+    }
+
+    for (int i = 1; i < workers.size(); i++) {
+        Worker *victim = workers[(index + i) % workers.size()];
+        QMutexLocker lock(&victim->mutex);
+        if (victim->count > 0) {
+            PoolTask *task = victim->tasks[victim->front & (TaskCapacity - 1)];
+            victim->front++;
+            victim->count--;
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Worker loop
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ProcessingPool::Worker::run()
+{
+    current_worker = this;
+
+    while (true) {
+        PoolTask *task = pool->take(index);
+        if (task) {
+            pool->queued.fetch_sub(1);
+            task->run();
+            pool->tasks_run.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        QMutexLocker lock(&pool->idle_mutex);
+        if (pool->stopping.load())
+            break;
+        pool->sleeping.fetch_add(1);
+        if (pool->queued.load() == 0)
+            pool->idle.wait(&pool->idle_mutex);
+        pool->sleeping.fetch_sub(1);
+    }
+}
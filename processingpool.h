@@ -0,0 +1,91 @@
+#ifndef PROCESSINGPOOL_H
+#define PROCESSINGPOOL_H
+
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <stdint.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Unit of work for the ProcessingPool. A task is never run by two
+// threads at once as long as it is not scheduled again before its run()
+// started - DevicePipeline guards this with its own flag.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class PoolTask
+{
+public:
+    virtual ~PoolTask() {}
+    virtual void run() = 0;
+
+private:
+    friend class ProcessingPool;
+    int home = -1;                  // worker whose deque external schedules go to
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Small work-stealing thread pool.
+//
+// Every worker thread has its own deque. Tasks scheduled from outside the
+// pool go to the back of their home worker's deque, tasks scheduled from
+// inside a pool thread to the back of that thread's deque, so a busy
+// device keeps running on a warm cache. A worker takes from the back of
+// its own deque and, once that is empty, steals from the front of the
+// others'. Idle workers sleep until something is scheduled.
+//
+// The deques are fixed rings of TaskCapacity, so scheduling never
+// allocates. A task is queued at most once at a time, so they only fill
+// up with more tasks than that; a task that finds no room anywhere is run
+// by the thread scheduling it.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class ProcessingPool
+{
+public:
+    static const int TaskCapacity = 64;             // per worker, a power of two
+
+    explicit ProcessingPool(int threads = 0);       // 0 - one thread per core
+    ~ProcessingPool();
+
+    void schedule(PoolTask *task);                  // any thread
+    void stop();                                    // tasks still queued are dropped
+
+    int threadCount() const { return workers.size(); }
+    uint64_t tasksRun() const { return tasks_run.load(std::memory_order_relaxed); }
+    uint64_t steals() const { return stolen.load(std::memory_order_relaxed); }
+
+private:
+    class Worker : public QThread
+    {
+    public:
+        Worker(ProcessingPool *pool, int index) : pool(pool), index(index) {}
+
+        ProcessingPool *pool;
+        int index;
+        QMutex mutex;
+        PoolTask* tasks[TaskCapacity];
+        uint32_t front = 0;         // free running index of the oldest task
+        int count = 0;
+
+    protected:
+        void run() override;
+    };
+
+    PoolTask *take(int index);
+    bool push(Worker *worker, PoolTask *task);
+
+    QVector<Worker*> workers;
+    std::atomic<uint32_t> next_home{0};
+
+    QMutex idle_mutex;
+    QWaitCondition idle;
+    std::atomic<int> queued{0};
+    std::atomic<int> sleeping{0};
+    std::atomic<bool> stopping{false};
+
+    std::atomic<uint64_t> tasks_run{0};
+    std::atomic<uint64_t> stolen{0};
+};
+
+#endif // PROCESSINGPOOL_H
@@ -589,6 +589,28 @@ QCPAbstractPaintBuffer::~QCPAbstractPaintBuffer()
 {
 }
 
+/*!
+  Shifts the content of the buffer inside \a rect horizontally by \a dx pixels (negative \a dx
+  moves it to the left) and fills \a exposed with \c Qt::transparent, ready to be drawn again.
+  Content shifted out of \a rect is lost, content outside of \a rect stays where it is. The
+  rects are given in device independent pixels, like everything painted through \ref
+  startPainting.
+
+  Returns false if the buffer can't shift its content by exactly that amount, in which case
+  nothing is changed. The default implementation always returns false. \ref QCPLayer::lmScrolling
+  layers on such buffers are drawn in full on every replot.
+
+  This method must not be called if there is currently a painter (acquired with \ref startPainting)
+  active.
+*/
+bool QCPAbstractPaintBuffer::scroll(const QRect &rect, int dx, const QRect &exposed)
+{
+  Q_UNUSED(rect)
+  Q_UNUSED(dx)
+  Q_UNUSED(exposed)
+  return false;
+}
+
 /*!
   Sets the paint buffer size.
 
@@ -699,6 +721,28 @@ void QCPPaintBufferPixmap::clear(const QColor &color)
   mBuffer.fill(color);
 }
 
+/* inherits documentation from base class */
+bool QCPPaintBufferPixmap::scroll(const QRect &rect, int dx, const QRect &exposed)
+{
+  if (dx != 0)
+  {
+    // QPixmap::scroll works on device pixels, so the shift must be whole pixels there, too
+    const double deviceDx = dx*mDevicePixelRatio;
+    if (!qFuzzyCompare(deviceDx, (double)qRound(deviceDx)))
+      return false;
+    QRect deviceRect(qRound(rect.x()*mDevicePixelRatio), qRound(rect.y()*mDevicePixelRatio),
+                     qRound(rect.width()*mDevicePixelRatio), qRound(rect.height()*mDevicePixelRatio));
+    mBuffer.scroll(qRound(deviceDx), 0, deviceRect);
+  }
+  if (!exposed.isEmpty())
+  {
+    QPainter painter(&mBuffer);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(exposed, Qt::transparent);
+  }
+  return true;
+}
+
 /* inherits documentation from base class */
 void QCPPaintBufferPixmap::reallocateBuffer()
 {
@@ -1036,6 +1080,26 @@ void QCPPaintBufferGlFbo::reallocateBuffer()
   compared with a full replot of all layers. Upon creation of a new layer, the layer mode is
   initialized to \ref lmLogical. The only layer that is set to \ref lmBuffered in a new \ref
   QCustomPlot instance is the "overlay" layer, containing the selection rect.
+
+  \section qcplayer-scrolling Strip charts
+
+  A layer in mode \ref lmScrolling has its own paint buffer like an \ref lmBuffered one, but keeps
+  its content from one replot to the next. For every axis rect whose bottom axis only moved on by
+  a whole number of pixels since the last replot (same rect, same key range size, same left axis
+  range), the buffer is shifted left by that many pixels and only the strip from the newest data
+  point drawn last time to the right edge is drawn again. Anything else, such as a resize, a
+  zoom, a drag by less than a pixel or a changed value range, draws the whole layer. While a strip
+  is drawn, plottables only get the keys it spans (see \ref QCPAbstractPlottable::drawKeyRange;
+  \ref QCPGraph honours it), so the cost of a replot grows with the data that came in since the
+  last one instead of with the width of the plot.
+
+  This is meant for plottables whose data only grows at the upper key end, and for grids that
+  scroll with them. Keep axes, titles and anything else that changes in place on other layers.
+  The layer can't see changes to the data further back or to the appearance of its layerables,
+  call \ref invalidateScroll after such a change so the next replot draws everything. To get
+  pixel exact shifts, move the key ranges by multiples of their size divided by the axis rect
+  width. Paint buffers that can't shift their content (see \ref QCPAbstractPaintBuffer::scroll)
+  draw the whole layer every time.
 */
 
 /* start documentation of inline functions */
@@ -1070,7 +1134,8 @@ QCPLayer::QCPLayer(QCustomPlot *parentPlot, const QString &layerName) :
   mName(layerName),
   mIndex(-1), // will be set to a proper value by the QCustomPlot layer creation function
   mVisible(true),
-  mMode(lmLogical)
+  mMode(lmLogical),
+  mScrollValid(false)
 {
   // Note: no need to make sure layerName is unique, because layer
   // management is done with QCustomPlot functions.
@@ -1101,6 +1166,7 @@ QCPLayer::~QCPLayer()
 void QCPLayer::setVisible(bool visible)
 {
   mVisible = visible;
+  mScrollValid = false;
 }
 
 /*!
@@ -1122,6 +1188,8 @@ void QCPLayer::setVisible(bool visible)
   only the topmost layer called "overlay" is in mode \ref lmBuffered, and contains the selection
   rect.
 
+  \ref lmScrolling gets a dedicated paint buffer as well, see \ref qcplayer-scrolling.
+
   \see replot
 */
 void QCPLayer::setMode(QCPLayer::LayerMode mode)
@@ -1129,6 +1197,7 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
   if (mMode != mode)
   {
     mMode = mode;
+    mScrollValid = false;
     if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
       pb->setInvalidated();
   }
@@ -1136,21 +1205,42 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
 
 /*! \internal
 
-  Draws the contents of this layer with the provided \a painter.
+  Draws the contents of this layer with the provided \a painter. If \a region is not empty,
+  nothing outside of it is touched: layerables that don't reach into it are skipped, and
+  plottables with a horizontal key axis only process the data of the keys the region spans (see
+  \ref QCPAbstractPlottable::drawKeyRange).
 
   \see replot, drawToPaintBuffer
 */
-void QCPLayer::draw(QCPPainter *painter)
+void QCPLayer::draw(QCPPainter *painter, const QRegion &region)
 {
   foreach (QCPLayerable *child, mChildren)
   {
     if (child->realVisibility())
     {
+      const QRect clip = child->clipRect().translated(0, -1);
+      QCPAbstractPlottable *plottable = nullptr;
+      if (!region.isEmpty())
+      {
+        const QRect bounds = region.intersected(clip).boundingRect();
+        if (bounds.isEmpty())
+          continue;
+        plottable = qobject_cast<QCPAbstractPlottable*>(child);
+        QCPAxis *keyAxis = plottable ? plottable->keyAxis() : nullptr;
+        if (keyAxis && keyAxis->orientation() == Qt::Horizontal)
+          plottable->mDrawKeyRange = QCPRange(keyAxis->pixelToCoord(bounds.left()), keyAxis->pixelToCoord(bounds.right()+1));
+        else
+          plottable = nullptr;
+      }
       painter->save();
-      painter->setClipRect(child->clipRect().translated(0, -1));
+      painter->setClipRect(clip);
+      if (!region.isEmpty())
+        painter->setClipRegion(region, Qt::IntersectClip);
       child->applyDefaultAntialiasingHint(painter);
       child->draw(painter);
       painter->restore();
+      if (plottable)
+        plottable->mDrawKeyRange = QCPRange(qQNaN(), qQNaN());
     }
   }
 }
@@ -1161,26 +1251,164 @@ void QCPLayer::draw(QCPPainter *painter)
   association is established by the parent QCustomPlot, which manages all paint buffers (see \ref
   QCustomPlot::setupPaintBuffers).
 
+  A layer in \ref lmScrolling mode first shifts the content of its buffer and only draws the
+  exposed strips, or clears the buffer and draws everything if it can't (see \ref
+  scrollPaintBuffer).
+
   \see draw
 */
 void QCPLayer::drawToPaintBuffer()
 {
   if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
   {
+    QRegion exposed;
+    if (mMode == lmScrolling)
+    {
+      if (!scrollPaintBuffer(pb.data(), &exposed))
+      {
+        pb->clear(Qt::transparent);
+        exposed = QRegion();
+      } else if (exposed.isEmpty())
+        return; // nothing new since the last replot
+    }
     if (QCPPainter *painter = pb->startPainting())
     {
       if (painter->isActive())
-        draw(painter);
+        draw(painter, exposed);
       else
         qDebug() << Q_FUNC_INFO << "paint buffer returned inactive painter";
       delete painter;
       pb->donePainting();
     } else
       qDebug() << Q_FUNC_INFO << "paint buffer returned nullptr painter";
+    if (mMode == lmScrolling)
+      saveScrollStates();
   } else
     qDebug() << Q_FUNC_INFO << "no valid paint buffer associated with this layer";
 }
 
+/*! \internal
+
+  Regenerates the ticks of the axes on this layer and of the axes whose grids are on it, which
+  otherwise only happens in the layout pass of a full \ref QCustomPlot::replot.
+
+  \see replot
+*/
+void QCPLayer::setupTickVectors()
+{
+  foreach (QCPLayerable *child, mChildren)
+  {
+    if (QCPAxis *axis = qobject_cast<QCPAxis*>(child))
+      axis->setupTickVectors();
+    else if (QCPGrid *grid = qobject_cast<QCPGrid*>(child))
+      grid->mParentAxis->setupTickVectors();
+  }
+}
+
+/*! \internal
+
+  Shifts the content of \a buffer along with the bottom axis of every axis rect, clears the
+  strips that need drawing again and returns them in \a exposed. A strip reaches from the newest
+  data point drawn by the last replot (less the width a line may have) to the right edge of the
+  axis rect, so the lines join up with what was drawn before.
+
+  Returns false, leaving the buffer untouched, if any axis rect changed in some other way since
+  the last replot, or the buffer can't scroll. Then the whole layer needs drawing.
+*/
+bool QCPLayer::scrollPaintBuffer(QCPAbstractPaintBuffer *buffer, QRegion *exposed)
+{
+  const QList<QCPAxisRect*> axisRects = mParentPlot->axisRects();
+  if (!mScrollValid || axisRects.size() != mScrollStates.size())
+    return false;
+  
+  // check every axis rect before touching the buffer
+  QVector<int> shifts(axisRects.size());
+  QVector<QRect> areas(axisRects.size()), strips(axisRects.size());
+  for (int i=0; i<axisRects.size(); ++i)
+  {
+    QCPAxisRect *axisRect = axisRects.at(i);
+    const ScrollState &state = mScrollStates.at(i);
+    QCPAxis *keyAxis = axisRect->axis(QCPAxis::atBottom);
+    QCPAxis *valueAxis = axisRect->axis(QCPAxis::atLeft);
+    if (state.axisRect != axisRect || state.rect != axisRect->rect() || !keyAxis || !valueAxis)
+      return false;
+    if (keyAxis->rangeReversed() || keyAxis->scaleType() != QCPAxis::stLinear)
+      return false;
+    const QCPRange keyRange = keyAxis->range();
+    const QCPRange valueRange = valueAxis->range();
+    if (!qFuzzyCompare(keyRange.size(), state.keySize) || valueRange.lower != state.valueLower || valueRange.upper != state.valueUpper)
+      return false;
+    
+    const double dx = (keyRange.lower-state.keyLower)/keyRange.size()*axisRect->width();
+    const int shift = qRound(dx);
+    if (qAbs(dx-shift) > 0.01 || shift < 0 || shift >= axisRect->width())
+      return false;
+    
+    const QRect area = axisRect->rect().translated(0, -1); // same as the clip rect in draw()
+    int left = area.right()+1-shift;
+    if (!qIsNaN(state.dataEnd))
+      left = qMin(left, qRound(keyAxis->coordToPixel(state.dataEnd))-state.margin);
+    left = qMax(left, area.left());
+    shifts[i] = shift;
+    areas[i] = area;
+    strips[i] = QRect(left, area.top(), area.right()+1-left, area.height());
+  }
+  
+  for (int i=0; i<axisRects.size(); ++i)
+  {
+    if (!buffer->scroll(areas.at(i), -shifts.at(i), strips.at(i)))
+      return false; // axis rects before this one are shifted already, the whole layer is drawn anyway
+    if (!strips.at(i).isEmpty())
+      *exposed += strips.at(i);
+  }
+  return true;
+}
+
+/*! \internal
+
+  Records what the layer drew into each axis rect, for \ref scrollPaintBuffer to compare the next
+  replot against.
+*/
+void QCPLayer::saveScrollStates()
+{
+  const QList<QCPAxisRect*> axisRects = mParentPlot->axisRects();
+  mScrollStates.resize(axisRects.size());
+  for (int i=0; i<axisRects.size(); ++i)
+  {
+    QCPAxisRect *axisRect = axisRects.at(i);
+    QCPAxis *keyAxis = axisRect->axis(QCPAxis::atBottom);
+    QCPAxis *valueAxis = axisRect->axis(QCPAxis::atLeft);
+    ScrollState &state = mScrollStates[i];
+    state.axisRect = axisRect;
+    state.rect = axisRect->rect();
+    state.keyLower = keyAxis ? keyAxis->range().lower : 0;
+    state.keySize = keyAxis ? keyAxis->range().size() : 0;
+    state.valueLower = valueAxis ? valueAxis->range().lower : 0;
+    state.valueUpper = valueAxis ? valueAxis->range().upper : 0;
+    state.dataEnd = qQNaN();
+    state.margin = 2; // antialiasing
+  }
+  
+  foreach (QCPLayerable *child, mChildren)
+  {
+    QCPAbstractPlottable *plottable = qobject_cast<QCPAbstractPlottable*>(child);
+    if (!plottable || !plottable->keyAxis())
+      continue;
+    const int index = axisRects.indexOf(plottable->keyAxis()->axisRect());
+    if (index < 0)
+      continue;
+    bool found = false;
+    const QCPRange keys = plottable->getKeyRange(found);
+    if (!found)
+      continue;
+    ScrollState &state = mScrollStates[index];
+    if (qIsNaN(state.dataEnd) || keys.upper > state.dataEnd)
+      state.dataEnd = keys.upper;
+    state.margin = qMax(state.margin, qCeil(plottable->pen().widthF())+2);
+  }
+  mScrollValid = true;
+}
+
 /*!
   If the layer mode (\ref setMode) is set to \ref lmBuffered, this method allows replotting only
   the layerables on this specific layer, without the need to replot all other layers (as a call to
@@ -1193,15 +1421,24 @@ void QCPLayer::drawToPaintBuffer()
   If the layer mode is \ref lmLogical however, this method simply calls \ref QCustomPlot::replot on
   the parent QCustomPlot instance.
 
+  An \ref lmScrolling layer is replotted individually as well, and scrolls as described in \ref
+  qcplayer-scrolling.
+
+  The ticks of axes on this layer, and of axes whose grids are on it, are brought up to date with
+  the current axis ranges first, so a layer holding axes follows range changes. The layout is not
+  updated though: if a change moves axis rects or margins, call \ref QCustomPlot::replot instead.
+
   \see draw
 */
 void QCPLayer::replot()
 {
-  if (mMode == lmBuffered && !mParentPlot->hasInvalidatedPaintBuffers())
+  if (mMode != lmLogical && !mParentPlot->hasInvalidatedPaintBuffers())
   {
     if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
     {
-      pb->clear(Qt::transparent);
+      setupTickVectors();
+      if (mMode == lmBuffered)
+        pb->clear(Qt::transparent);
       drawToPaintBuffer();
       pb->setInvalidated(false); // since layer is lmBuffered, we know only this layer is on buffer and we can reset invalidated flag
       mParentPlot->update();
@@ -1211,6 +1448,19 @@ void QCPLayer::replot()
     mParentPlot->replot();
 }
 
+/*!
+  Makes the next replot of an \ref lmScrolling layer draw the whole layer instead of only the
+  newly exposed strips. Call this after changing anything the layer can't notice by itself, like
+  the visibility or pen of a plottable on it, or data behind the newest data point.
+
+  Adding or removing layerables, resizing the plot and changing the mode invalidate the scroll
+  state already.
+*/
+void QCPLayer::invalidateScroll()
+{
+  mScrollValid = false;
+}
+
 /*! \internal
   
   Adds the \a layerable to the list of this layer. If \a prepend is set to true, the layerable will
@@ -11425,7 +11675,8 @@ QCPAbstractPlottable::QCPAbstractPlottable(QCPAxis *keyAxis, QCPAxis *valueAxis)
   mKeyAxis(keyAxis),
   mValueAxis(valueAxis),
   mSelectable(QCP::stWhole),
-  mSelectionDecorator(nullptr)
+  mSelectionDecorator(nullptr),
+  mDrawKeyRange(qQNaN(), qQNaN())
 {
   if (keyAxis->parentPlot() != valueAxis->parentPlot())
     qDebug() << Q_FUNC_INFO << "Parent plot of keyAxis is not the same as that of valueAxis.";
@@ -11947,6 +12198,26 @@ void QCPAbstractPlottable::applyScattersAntialiasingHint(QCPPainter *painter) co
   applyAntialiasingHint(painter, mAntialiasedScatters, QCP::aeScatters);
 }
 
+/*! \internal
+
+  Returns the key range the plottable has to draw: the range of its key axis, or while a layer in
+  \ref QCPLayer::lmScrolling mode redraws only a strip, the part of it the strip spans. Data
+  outside of it would be clipped away anyway, so implementations only need to process it plus one
+  point on either side, which makes the lines into the strip.
+
+  The returned range is empty (lower above upper) if the strip and the axis range don't overlap.
+*/
+QCPRange QCPAbstractPlottable::drawKeyRange() const
+{
+  QCPRange range = mKeyAxis ? mKeyAxis.data()->range() : QCPRange();
+  if (!qIsNaN(mDrawKeyRange.lower))
+  {
+    range.lower = qMax(range.lower, mDrawKeyRange.lower);
+    range.upper = qMin(range.upper, mDrawKeyRange.upper);
+  }
+  return range;
+}
+
 /* inherits documentation from base class */
 void QCPAbstractPlottable::selectEvent(QMouseEvent *event, bool additive, const QVariant &details, bool *selectionStateChanged)
 {
@@ -14872,6 +15143,51 @@ bool QCustomPlot::moveLayer(QCPLayer *layer, QCPLayer *otherLayer, QCustomPlot::
   return true;
 }
 
+/*!
+  Rearranges the layers for a strip chart, where new data keeps coming in at the upper key end and
+  the key axes scroll along with it, while everything else rarely changes. Afterwards:
+
+  \li all grids and plottables are on the layer "strip" in mode \ref QCPLayer::lmScrolling,
+  directly above "grid", so each replot only draws the data that came in since the last one (see
+  \ref qcplayer-scrolling).
+  \li the horizontal axes of all axis rects are on the layer "keyAxes" in mode \ref
+  QCPLayer::lmBuffered, directly below "overlay", since their ticks move with every scroll.
+  \li everything else stays on the default layers. Above "strip", the layers "main", "axes" and
+  "legend" share one paint buffer, which caches the vertical axes, the axis box lines, titles and
+  legends.
+
+  While only data was added and key ranges moved, replotting "keyAxes" and "strip" with \ref
+  QCPLayer::replot is enough and leaves the cached buffers alone. Use \ref replot when anything
+  else changed.
+
+  Only layerables that exist when this is called are moved; the layers are created if they don't
+  exist yet, so calling it again after adding axis rects or plottables moves those too.
+*/
+void QCustomPlot::setupStripChartLayers()
+{
+  if (!layer(QLatin1String("strip")))
+    addLayer(QLatin1String("strip"), layer(QLatin1String("grid")), limAbove);
+  if (!layer(QLatin1String("keyAxes")))
+    addLayer(QLatin1String("keyAxes"), layer(QLatin1String("overlay")), limBelow);
+  QCPLayer *strip = layer(QLatin1String("strip"));
+  QCPLayer *keyAxes = layer(QLatin1String("keyAxes"));
+  strip->setMode(QCPLayer::lmScrolling);
+  keyAxes->setMode(QCPLayer::lmBuffered);
+  
+  // grids first, so they stay beneath the plottables
+  foreach (QCPAxisRect *axisRect, axisRects())
+  {
+    foreach (QCPAxis *axis, axisRect->axes())
+    {
+      axis->grid()->setLayer(strip);
+      if (axis->orientation() == Qt::Horizontal)
+        axis->setLayer(keyAxes);
+    }
+  }
+  foreach (QCPAbstractPlottable *plottable, mPlottables)
+    plottable->setLayer(strip);
+}
+
 /*!
   Returns the number of axis rects in the plot.
   
@@ -15830,7 +16146,8 @@ void QCustomPlot::drawBackground(QCPPainter *painter)
   This method uses \ref createPaintBuffer to create new paint buffers.
 
   After this method, the paint buffers are empty (filled with \c Qt::transparent) and invalidated
-  (so an attempt to replot only a single buffered layer causes a full replot).
+  (so an attempt to replot only a single buffered layer causes a full replot). The buffers of \ref
+  QCPLayer::lmScrolling layers keep their content, the layer clears them itself if it can't scroll.
 
   This method is called in every \ref replot call, prior to actually drawing the layers (into their
   associated paint buffer). If the paint buffers don't need changing/reallocating, this method
@@ -15838,6 +16155,7 @@ void QCustomPlot::drawBackground(QCPPainter *painter)
 */
 void QCustomPlot::setupPaintBuffers()
 {
+  QHash<QCPAbstractPaintBuffer*, QCPLayer*> scrollingBuffers;
   int bufferIndex = 0;
   if (mPaintBuffers.isEmpty())
     mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
@@ -15848,11 +16166,17 @@ void QCustomPlot::setupPaintBuffers()
     if (layer->mode() == QCPLayer::lmLogical)
     {
       layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
-    } else if (layer->mode() == QCPLayer::lmBuffered)
+    } else // lmBuffered or lmScrolling
     {
       ++bufferIndex;
       if (bufferIndex >= mPaintBuffers.size())
         mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
+      if (layer->mode() == QCPLayer::lmScrolling)
+      {
+        if (layer->mPaintBuffer.toStrongRef() != mPaintBuffers.at(bufferIndex))
+          layer->invalidateScroll(); // buffer holds what another layer drew
+        scrollingBuffers.insert(mPaintBuffers.at(bufferIndex).data(), layer);
+      }
       layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
       if (layerIndex < mLayers.size()-1 && mLayers.at(layerIndex+1)->mode() == QCPLayer::lmLogical) // not last layer, and next one is logical, so prepare another buffer for next layerables
       {
@@ -15865,11 +16189,16 @@ void QCustomPlot::setupPaintBuffers()
   // remove unneeded buffers:
   while (mPaintBuffers.size()-1 > bufferIndex)
     mPaintBuffers.removeLast();
-  // resize buffers to viewport size and clear contents:
+  // resize buffers to viewport size and clear contents, except where a scrolling layer reuses them:
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
   {
     buffer->setSize(viewport().size()); // won't do anything if already correct size
-    buffer->clear(Qt::transparent);
+    if (QCPLayer *layer = scrollingBuffers.value(buffer.data()))
+    {
+      if (buffer->invalidated()) // reallocated, or layerables came or went
+        layer->invalidateScroll();
+    } else
+      buffer->clear(Qt::transparent);
     buffer->setInvalidated();
   }
 }
@@ -21977,9 +22306,16 @@ void QCPGraph::getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin
     QCPAxis *keyAxis = mKeyAxis.data();
     QCPAxis *valueAxis = mValueAxis.data();
     if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
-    // get visible data range:
-    begin = mDataContainer->findBegin(keyAxis->range().lower);
-    end = mDataContainer->findEnd(keyAxis->range().upper);
+    // get visible data range, only the strip a scrolling layer redraws (and a point either side):
+    const QCPRange keyRange = drawKeyRange();
+    if (keyRange.lower > keyRange.upper)
+    {
+      end = mDataContainer->constEnd();
+      begin = end;
+      return;
+    }
+    begin = mDataContainer->findBegin(keyRange.lower);
+    end = mDataContainer->findEnd(keyRange.upper);
     // limit lower/upperEnd to rangeRestriction:
     mDataContainer->limitIteratorsToDataRange(begin, end, rangeRestriction); // this also ensures rangeRestriction outside data bounds doesn't break anything
   }
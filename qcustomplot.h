@@ -592,6 +592,7 @@ public:
   virtual void donePainting() {}
   virtual void draw(QCPPainter *painter) const = 0;
   virtual void clear(const QColor &color) = 0;
+  virtual bool scroll(const QRect &rect, int dx, const QRect &exposed);
   
 protected:
   // property members:
@@ -616,6 +617,7 @@ public:
   virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
   virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
   void clear(const QColor &color) Q_DECL_OVERRIDE;
+  virtual bool scroll(const QRect &rect, int dx, const QRect &exposed) Q_DECL_OVERRIDE;
   
 protected:
   // non-property members:
@@ -701,6 +703,7 @@ public:
   */
   enum LayerMode { lmLogical   ///< Layer is used only for rendering order, and shares paint buffer with all other adjacent logical layers.
                    ,lmBuffered ///< Layer has its own paint buffer and may be replotted individually (see \ref replot).
+                   ,lmScrolling ///< Like \ref lmBuffered, but a replot shifts what is already drawn along with the key axes and only draws the newly exposed strips (see \ref qcplayer-scrolling).
                  };
   Q_ENUMS(LayerMode)
   
@@ -721,8 +724,20 @@ public:
   
   // non-virtual methods:
   void replot();
+  void invalidateScroll();
   
 protected:
+  // what an lmScrolling layer last drew into one axis rect
+  struct ScrollState
+  {
+    QPointer<QCPAxisRect> axisRect;
+    QRect rect;
+    double keyLower, keySize;
+    double valueLower, valueUpper;
+    double dataEnd;     // newest key drawn, NaN if none
+    int margin;         // pixels a line may reach beyond a data point
+  };
+  
   // property members:
   QCustomPlot *mParentPlot;
   QString mName;
@@ -733,10 +748,15 @@ protected:
   
   // non-property members:
   QWeakPointer<QCPAbstractPaintBuffer> mPaintBuffer;
+  QVector<ScrollState> mScrollStates;
+  bool mScrollValid;
   
   // non-virtual methods:
-  void draw(QCPPainter *painter);
+  void draw(QCPPainter *painter, const QRegion &region=QRegion());
   void drawToPaintBuffer();
+  void setupTickVectors();
+  bool scrollPaintBuffer(QCPAbstractPaintBuffer *buffer, QRegion *exposed);
+  void saveScrollStates();
   void addChild(QCPLayerable *layerable, bool prepend);
   void removeChild(QCPLayerable *layerable);
   
@@ -2114,6 +2134,7 @@ protected:
   void drawSubGridLines(QCPPainter *painter) const;
   
   friend class QCPAxis;
+  friend class QCPLayer;
 };
 
 
@@ -2413,6 +2434,7 @@ private:
   friend class QCustomPlot;
   friend class QCPGrid;
   friend class QCPAxisRect;
+  friend class QCPLayer;
 };
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCPAxis::SelectableParts)
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCPAxis::AxisTypes)
@@ -2622,9 +2644,11 @@ public:
   int size() const { return mData.size()-mPreallocSize; }
   bool isEmpty() const { return size() == 0; }
   bool autoSqueeze() const { return mAutoSqueeze; }
+  int ringCapacity() const { return mRingCapacity; }
   
   // setters:
   void setAutoSqueeze(bool enabled);
+  void setRingCapacity(int capacity);
   
   // non-virtual methods:
   void set(const QCPDataContainer<DataType> &data);
@@ -2655,6 +2679,7 @@ public:
 protected:
   // property members:
   bool mAutoSqueeze;
+  int mRingCapacity;
   
   // non-property memebers:
   QVector<DataType> mData;
@@ -2664,6 +2689,8 @@ protected:
   // non-virtual methods:
   void preallocateGrow(int minimumPreallocSize);
   void performAutoSqueeze();
+  void ringMakeRoom(int n);
+  void ringEnforceCapacity();
 };
 
 
@@ -2689,6 +2716,9 @@ protected:
   specifying that added data is already itself sorted by key, if he can guarantee that this is the
   case (see for example \ref add(const QVector<DataType> &data, bool alreadySorted)).
 
+  For strip-chart workloads, where new data is always appended and old data is trimmed from the
+  front, the container can be switched to a fixed capacity ring mode with \ref setRingCapacity.
+
   The data can be accessed with the provided const iterators (\ref constBegin, \ref constEnd). If
   it is necessary to alter existing data in-place, the non-const iterators can be used (\ref begin,
   \ref end). Changing data members that are not the sort key (for most data types called \a key) is
@@ -2805,6 +2835,7 @@ protected:
 template <class DataType>
 QCPDataContainer<DataType>::QCPDataContainer() :
   mAutoSqueeze(true),
+  mRingCapacity(0),
   mPreallocSize(0),
   mPreallocIteration(0)
 {
@@ -2829,6 +2860,42 @@ void QCPDataContainer<DataType>::setAutoSqueeze(bool enabled)
   }
 }
 
+/*!
+  Switches the container to ring mode, holding at most \a capacity data points. Pass 0 to return
+  to the normal, unbounded mode.
+
+  In ring mode the container allocates storage for twice \a capacity once and never reallocates.
+  Appending data (with respect to the sort key) then takes constant time: when the container is
+  full, the oldest data points are dropped to make room. Trimming from the front (\ref
+  removeBefore) only advances the start of the valid range. Once appends reach the end of the
+  storage, the valid range is moved back to the start in a single copy, which happens at most
+  every \a capacity appends, so the amortized cost of an append stays constant.
+
+  The valid data points always occupy one contiguous block, so the iterators and the binary
+  searches of \ref findBegin and \ref findEnd work exactly as in the normal mode. Inserting data
+  between existing keys or prepending is still supported, but falls back to the normal (non
+  constant time) code path.
+
+  If the container currently holds more than \a capacity data points, the oldest ones are removed.
+
+  \see ringCapacity, removeBefore
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::setRingCapacity(int capacity)
+{
+  capacity = qMax(0, capacity);
+  if (mRingCapacity == capacity)
+    return;
+  mRingCapacity = capacity;
+  if (mRingCapacity > 0)
+  {
+    squeeze(true, false);
+    mData.reserve(2*mRingCapacity);
+    ringEnforceCapacity();
+  } else if (mAutoSqueeze)
+    performAutoSqueeze();
+}
+
 /*! \overload
   
   Replaces the current data in this container with the provided \a data.
@@ -2859,6 +2926,8 @@ void QCPDataContainer<DataType>::set(const QVector<DataType> &data, bool already
   mPreallocIteration = 0;
   if (!alreadySorted)
     sort();
+  if (mRingCapacity > 0)
+    ringEnforceCapacity();
 }
 
 /*! \overload
@@ -2889,6 +2958,8 @@ void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
     if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
       std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
   }
+  if (mRingCapacity > 0)
+    ringEnforceCapacity();
 }
 
 /*!
@@ -2910,6 +2981,15 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
     return;
   }
   
+  if (mRingCapacity > 0 && alreadySorted && !qcpLessThanSortKey<DataType>(*data.constBegin(), *(constEnd()-1))) // ring mode append, only the newest mRingCapacity points can survive
+  {
+    const int n = qMin(data.size(), mRingCapacity);
+    ringMakeRoom(n);
+    mData.resize(mData.size()+n);
+    std::copy(data.constEnd()-n, data.constEnd(), end()-n);
+    return;
+  }
+  
   const int n = data.size();
   const int oldSize = size();
   
@@ -2928,6 +3008,8 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
     if (oldSize > 0 && !qcpLessThanSortKey<DataType>(*(constEnd()-n-1), *(constEnd()-n))) // if appended range keys aren't all greater than existing ones, merge the two partitions
       std::inplace_merge(begin(), end()-n, end(), qcpLessThanSortKey<DataType>);
   }
+  if (mRingCapacity > 0)
+    ringEnforceCapacity();
 }
 
 /*! \overload
@@ -2941,6 +3023,8 @@ void QCPDataContainer<DataType>::add(const DataType &data)
 {
   if (isEmpty() || !qcpLessThanSortKey<DataType>(data, *(constEnd()-1))) // quickly handle appends if new data key is greater or equal to existing ones
   {
+    if (mRingCapacity > 0)
+      ringMakeRoom(1);
     mData.append(data);
   } else if (qcpLessThanSortKey<DataType>(data, *constBegin()))  // quickly handle prepends using preallocated space
   {
@@ -2953,6 +3037,8 @@ void QCPDataContainer<DataType>::add(const DataType &data)
     QCPDataContainer<DataType>::iterator insertionPoint = std::lower_bound(begin(), end(), data, qcpLessThanSortKey<DataType>);
     mData.insert(insertionPoint, data);
   }
+  if (mRingCapacity > 0)
+    ringEnforceCapacity();
 }
 
 /*!
@@ -3040,6 +3126,8 @@ void QCPDataContainer<DataType>::clear()
   mData.clear();
   mPreallocIteration = 0;
   mPreallocSize = 0;
+  if (mRingCapacity > 0)
+    mData.reserve(2*mRingCapacity);
 }
 
 /*!
@@ -3067,7 +3155,8 @@ void QCPDataContainer<DataType>::sort()
   applications.
   
   The parameters \a preAllocation and \a postAllocation control whether pre- and/or post allocation
-  should be freed, respectively.
+  should be freed, respectively. In ring mode (\ref setRingCapacity), the postallocation is part of
+  the fixed ring storage and is never freed.
 */
 template <class DataType>
 void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation)
@@ -3082,7 +3171,7 @@ void QCPDataContainer<DataType>::squeeze(bool preAllocation, bool postAllocation
     }
     mPreallocIteration = 0;
   }
-  if (postAllocation)
+  if (postAllocation && mRingCapacity == 0)
     mData.squeeze();
 }
 
@@ -3419,6 +3508,9 @@ void QCPDataContainer<DataType>::preallocateGrow(int minimumPreallocSize)
 template <class DataType>
 void QCPDataContainer<DataType>::performAutoSqueeze()
 {
+  if (mRingCapacity > 0) // ring storage is allocated once and reused, see ringMakeRoom
+    return;
+  
   const int totalAlloc = mData.capacity();
   const int postAllocSize = totalAlloc-mData.size();
   const int usedSize = size();
@@ -3439,6 +3531,49 @@ void QCPDataContainer<DataType>::performAutoSqueeze()
 }
 
 
+/*! \internal
+  
+  Prepares the ring storage for appending \a n data points (\a n must not exceed the ring
+  capacity): drops the oldest data points if the capacity would be exceeded, and moves the valid
+  range back to the start of the storage if the appended points wouldn't fit behind it anymore.
+  
+  \see setRingCapacity
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::ringMakeRoom(int n)
+{
+  const int excess = size()+n-mRingCapacity;
+  if (excess > 0)
+    mPreallocSize += qMin(excess, size());
+  if (mData.size()+n > 2*mRingCapacity)
+  {
+    const int usedSize = size();
+    std::copy(mData.constBegin()+mPreallocSize, mData.constEnd(), mData.begin()); // destination starts before source, so forward copy is safe
+    mData.resize(usedSize); // stays within the reserved storage, no reallocation
+    mPreallocSize = 0;
+  }
+}
+
+/*! \internal
+  
+  Restores the ring mode invariants after an operation that used the normal code path (inserts,
+  prepends, merges): at most \ref ringCapacity valid data points, stored in the reserved ring
+  storage.
+  
+  \see setRingCapacity
+*/
+template <class DataType>
+void QCPDataContainer<DataType>::ringEnforceCapacity()
+{
+  if (size() > mRingCapacity)
+    mPreallocSize += size()-mRingCapacity;
+  if (mData.size() > 2*mRingCapacity || mData.capacity() < 2*mRingCapacity)
+  {
+    squeeze(true, false);
+    mData.reserve(2*mRingCapacity);
+  }
+}
+
 /* end of 'src/datacontainer.h' */
 
 
@@ -3571,6 +3706,9 @@ protected:
   QCPDataSelection mSelection;
   QCPSelectionDecorator *mSelectionDecorator;
   
+  // non-property members:
+  QCPRange mDrawKeyRange; // keys a scrolling layer redraws, NaN while everything is drawn (see QCPLayer::draw)
+  
   // reimplemented virtual methods:
   virtual QRect clipRect() const Q_DECL_OVERRIDE;
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE = 0;
@@ -3586,12 +3724,14 @@ protected:
   // non-virtual methods:
   void applyFillAntialiasingHint(QCPPainter *painter) const;
   void applyScattersAntialiasingHint(QCPPainter *painter) const;
+  QCPRange drawKeyRange() const;
 
 private:
   Q_DISABLE_COPY(QCPAbstractPlottable)
   
   friend class QCustomPlot;
   friend class QCPAxis;
+  friend class QCPLayer;
   friend class QCPPlottableLegendItem;
 };
 
@@ -3918,6 +4058,7 @@ public:
   bool addLayer(const QString &name, QCPLayer *otherLayer=nullptr, LayerInsertMode insertMode=limAbove);
   bool removeLayer(QCPLayer *layer);
   bool moveLayer(QCPLayer *layer, QCPLayer *otherLayer, LayerInsertMode insertMode=limAbove);
+  void setupStripChartLayers();
   
   // axis rect/layout interface:
   int axisRectCount() const;
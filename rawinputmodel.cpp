@@ -0,0 +1,103 @@
+#include "rawinputmodel.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+RawInputModel::RawInputModel(QObject *parent) :
+    QAbstractTableModel(parent)
+{
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Keep a sample, overwriting the oldest once the ring is full
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void RawInputModel::append(int device, const CprSample &sample)
+{
+    Entry &entry = entries[written & (Capacity - 1)];
+    entry.device = device;
+    entry.x = sample.acl_x;
+    entry.y = sample.acl_y;
+    entry.z = sample.acl_z;
+    written++;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Show what was appended since the last call; every row moves down, but
+// the view only fetches the ones on screen again
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void RawInputModel::publish()
+{
+    if (written == shown)
+        return;
+
+    int new_rows = written < (uint64_t)Capacity ? (int)written : Capacity;
+    if (new_rows > rows) {
+        beginInsertRows(QModelIndex(), rows, new_rows - 1);
+        shown = written;
+        rows = new_rows;
+        endInsertRows();
+    } else {
+        shown = written;
+    }
+    emit dataChanged(index(0, 0), index(rows - 1, ColumnCount - 1));
+}
+
+int RawInputModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows;
+}
+
+int RawInputModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Text of one cell, made when the view paints it. Samples appended since
+// publish() have already reused the slots of the oldest rows, which stay
+// blank until the next publish() rather than show newer samples
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+QVariant RawInputModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows)
+        return QVariant();
+    if ((uint64_t)index.row() >= (uint64_t)Capacity - qMin(written - shown, (uint64_t)Capacity))
+        return QVariant();
+    if (role == Qt::TextAlignmentRole)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    const Entry &entry = entries[(shown - 1 - index.row()) & (Capacity - 1)];
+    switch (index.column()) {
+    case DeviceColumn:
+        return entry.device;
+    case XColumn:
+        return QString::number(entry.x);
+    case YColumn:
+        return QString::number(entry.y);
+    case ZColumn:
+        return QString::number(entry.z);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant RawInputModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (section) {
+    case DeviceColumn:
+        return "Device";
+    case XColumn:
+        return "x";
+    case YColumn:
+        return "y";
+    case ZColumn:
+        return "z";
+    default:
+        return QVariant();
+    }
+}
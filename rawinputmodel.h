@@ -0,0 +1,60 @@
+#ifndef RAWINPUTMODEL_H
+#define RAWINPUTMODEL_H
+
+#include <QAbstractTableModel>
+
+#include <stdint.h>
+
+#include "cprsample.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The last Capacity decoded samples of all devices, newest first, for the
+// raw input view.
+//
+// append() only copies the values into a fixed ring, so it costs the same
+// whether the view is shown or not and memory does not grow with the
+// session. The view sees new samples once publish() is called - once per
+// plot update, and only while it is visible - and text is made in data()
+// for the rows it actually paints. Rows whose slot append() has reused
+// in the meantime read as empty until then.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class RawInputModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static const int Capacity = 4096;           // must be a power of two
+
+    enum Column {
+        DeviceColumn,
+        XColumn,
+        YColumn,
+        ZColumn,
+        ColumnCount
+    };
+
+    explicit RawInputModel(QObject *parent = nullptr);
+
+    void append(int device, const CprSample &sample);
+    void publish();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Entry {
+        int device;             // 1 based
+        float x;
+        float y;
+        float z;
+    };
+
+    Entry entries[Capacity];
+    uint64_t written = 0;       // appended so far
+    uint64_t shown = 0;         // written as of the last publish(), row 0 is the one before it
+    int rows = 0;
+};
+
+#endif // RAWINPUTMODEL_H
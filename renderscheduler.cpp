@@ -0,0 +1,41 @@
+#include "renderscheduler.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Time between display refreshes; replots never come faster
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void RenderScheduler::setFrameInterval(int64_t nanoseconds)
+{
+    frame_interval = nanoseconds > 0 ? nanoseconds : 1;
+    interval = frame_interval;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Something changed and the last replot is long enough ago
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool RenderScheduler::isDue(int64_t now) const
+{
+    return dirty && now - last_render >= interval - frame_interval / 2;    // half a frame of timer jitter
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// A replot finished at now and took replot_ms; adapt the interval
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void RenderScheduler::rendered(int64_t now, double replot_ms)
+{
+    dirty = false;
+    last_render = now;
+    renders++;
+
+    double cost = replot_ms * 1.0e6;
+    replot_cost = renders == 1 ? cost : replot_cost * 0.8 + cost * 0.2;
+
+    if (replot_cost > interval / 2 && interval < MaxInterval) {
+        interval *= 2;
+        if (interval > MaxInterval)
+            interval = MaxInterval;
+    } else if (replot_cost < interval / 8 && interval > frame_interval) {
+        interval /= 2;
+        if (interval < frame_interval)
+            interval = frame_interval;
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <stdint.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Decides when the live plot is redrawn.
+//
+// The plot timer ticks once per display frame and always drains the
+// sample queues, but isDue() only asks for a replot when something was
+// marked dirty since the last one. When a replot takes more than half of
+// the time between replots that interval doubles, up to MaxInterval, and
+// it halves again, back down to one frame, once replots need less than
+// an eighth of it - a slow machine draws fewer frames instead of doing
+// nothing else.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class RenderScheduler
+{
+public:
+    static const int64_t MaxInterval = 250000000;  // ns
+
+    void setFrameInterval(int64_t nanoseconds);
+    int64_t frameInterval() const { return frame_interval; }
+
+    void markDirty() { dirty = true; }
+    bool isDue(int64_t now) const;
+    void rendered(int64_t now, double replot_ms);
+
+    int64_t renderInterval() const { return interval; }
+    uint64_t renderCount() const { return renders; }
+    double renderTime() const { return replot_cost / 1.0e6; }  // ms, smoothed
+
+private:
+    int64_t frame_interval = 16666667;
+    int64_t interval = 16666667;
+    int64_t last_render = 0;
+    double replot_cost = 0.0;       // ns, smoothed
+    bool dirty = true;
+    uint64_t renders = 0;
+};
+
+#endif // RENDERSCHEDULER_H
@@ -0,0 +1,112 @@
+#include "replaysource.h"
+
+#include <string.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Map a session file and check its header
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool ReplaySource::open(const QString &fileName)
+{
+    close();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error_string = file.errorString();
+        return false;
+    }
+
+    SessionFile::Header header;
+    if (file.read((char *)&header, sizeof(header)) != sizeof(header)
+            || memcmp(header.magic, SessionFile::Magic, sizeof(header.magic)) != 0
+            || header.version != SessionFile::Version
+            || header.record_size != sizeof(SessionFile::Record)) {
+        error_string = "not a CPR session file";
+        file.close();
+        return false;
+    }
+
+    record_count = (file.size() - (qint64)sizeof(header)) / (qint64)sizeof(SessionFile::Record);
+    if (record_count > 0) {
+        uchar *mapped = file.map(sizeof(header), record_count * sizeof(SessionFile::Record));
+        if (!mapped) {
+            error_string = file.errorString();
+            file.close();
+            return false;
+        }
+        records = (const SessionFile::Record *)mapped;
+    }
+
+    error_string.clear();
+    next_record = 0;
+    return true;
+}
+
+void ReplaySource::close()
+{
+    if (records)
+        file.unmap((uchar *)records);
+    records = nullptr;
+    record_count = 0;
+    next_record = 0;
+    if (file.isOpen())
+        file.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Begin replay at host time now
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void ReplaySource::start(int64_t now)
+{
+    start_time = now;
+    next_record = 0;
+    have_first = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Fetch the next frame due at host time now; its replayed receive time
+// goes to timestamp. Returns false if nothing is due yet or at the end.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool ReplaySource::nextFrame(int64_t now, int64_t *timestamp)
+{
+    while (next_record < record_count) {
+        const SessionFile::Record *record = records + next_record;
+
+        if (record->device != replay_device) {
+            next_record++;
+            continue;
+        }
+
+        if (!have_first) {
+            first_timestamp = record->timestamp;
+            have_first = true;
+        }
+
+        int64_t due = now;
+        if (replay_speed > 0.0) {
+            due = start_time + (int64_t)((record->timestamp - first_timestamp) / replay_speed);
+            if (due > now)
+                return false;
+        }
+
+        // reassemble frames that continue over several records
+        frame_size = 0;
+        do {
+            record = records + next_record++;
+            if (record->device != replay_device)
+                continue;
+            int len = record->length;
+            if (len > (int)sizeof(record->frame))
+                len = sizeof(record->frame);
+            if (frame_size + len <= MaxFrameSize) {
+                memcpy(frame_buffer + frame_size, record->frame, len);
+                frame_size += len;
+            }
+            if (!(record->flags & SessionFile::RecordContinued))
+                break;
+        } while (next_record < record_count);
+
+        *timestamp = due;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <QFile>
+#include <QString>
+
+#include "sessionfile.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Reads a recorded session (see SessionRecorder) back frame by frame.
+//
+// The file is memory mapped, so replay costs no copies beyond
+// reassembling frames that span continuation records. Frames are handed
+// out once they are due: at the recorded pace scaled by the replay
+// speed, or immediately when the speed is 0 (as fast as possible).
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class ReplaySource
+{
+public:
+    static const int MaxFrameSize = 16 * sizeof(SessionFile::Record::frame);
+
+    ReplaySource() {}
+    ~ReplaySource() { close(); }
+
+    bool open(const QString &fileName);
+    void close();
+    QString errorString() const { return error_string; }
+
+    void setSpeed(double speed) { replay_speed = speed > 0.0 ? speed : 0.0; }
+    double speed() const { return replay_speed; }
+    void setDevice(uint16_t device) { replay_device = device; }
+
+    void start(int64_t now);
+    bool nextFrame(int64_t now, int64_t *timestamp);
+    bool atEnd() const { return next_record >= record_count; }
+
+    const uint8_t *frame() const { return frame_buffer; }
+    int frameSize() const { return frame_size; }
+    int64_t recordCount() const { return record_count; }
+
+private:
+    QFile file;
+    QString error_string;
+    const SessionFile::Record *records = nullptr;
+    int64_t record_count = 0;
+    int64_t next_record = 0;
+
+    double replay_speed = 1.0;
+    uint16_t replay_device = 0;
+    int64_t start_time = 0;             // host time the replay started at
+    int64_t first_timestamp = 0;        // recorded time of the first replayed frame
+    bool have_first = false;
+
+    uint8_t frame_buffer[MaxFrameSize];
+    int frame_size = 0;
+};
+
+#endif // REPLAYSOURCE_H
@@ -0,0 +1,41 @@
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include <stdint.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// On-disk layout of a recorded session (*.cprs), little endian.
+//
+// A 16 byte header is followed by fixed size 32 byte records, one per
+// received frame, in the order the frames were decoded. Frames longer
+// than one record's payload continue in the following records, which
+// carry the RecordContinued flag on all but the last one.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+namespace SessionFile {
+
+static const char Magic[4] = { 'C', 'P', 'R', 'S' };
+static const uint16_t Version = 1;
+
+static const uint8_t RecordContinued = 0x01;
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    int64_t created;            // wall clock, ms since epoch
+} Header;
+
+typedef struct {
+    int64_t timestamp;          // monotonicNanoseconds() when the frame was read from the socket
+    uint16_t device;            // index of the manikin the frame came from
+    uint8_t length;             // valid bytes in frame[]
+    uint8_t flags;
+    uint8_t frame[20];          // raw frame bytes, starting at the 0xAA header
+} Record;
+
+static_assert(sizeof(Header) == 16, "session file header must be 16 bytes");
+static_assert(sizeof(Record) == 32, "session file record must be 32 bytes");
+
+}
+
+#endif // SESSIONFILE_H
@@ -0,0 +1,158 @@
+#include "sessionrecorder.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include <string.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+SessionRecorder::SessionRecorder(QObject *parent) :
+    QThread(parent)
+{
+    front.reserve(BufferRecords * (int)sizeof(SessionFile::Record));
+    back.reserve(BufferRecords * (int)sizeof(SessionFile::Record));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Destructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Create the session file and start the writer thread
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool SessionRecorder::open(const QString &fileName)
+{
+    close();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error_string = file.errorString();
+        return false;
+    }
+
+    SessionFile::Header header;
+    memcpy(header.magic, SessionFile::Magic, sizeof(header.magic));
+    header.version = SessionFile::Version;
+    header.record_size = sizeof(SessionFile::Record);
+    header.created = QDateTime::currentMSecsSinceEpoch();
+    if (file.write((const char *)&header, sizeof(header)) != sizeof(header)) {
+        error_string = file.errorString();
+        file.close();
+        return false;
+    }
+
+    mutex.lock();
+    error_string.clear();
+    records_written.store(0, std::memory_order_relaxed);
+    dropped_records.store(0, std::memory_order_relaxed);
+    front.resize(0);
+    back.resize(0);
+    stopping = false;
+    recording.store(true, std::memory_order_release);
+    mutex.unlock();
+
+    start();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Write out whatever is buffered and close the file
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void SessionRecorder::close()
+{
+    if (!isRunning())
+        return;
+
+    mutex.lock();
+    recording.store(false, std::memory_order_release);
+    stopping = true;
+    buffer_ready.wakeOne();
+    mutex.unlock();
+
+    wait();
+    file.close();
+}
+
+QString SessionRecorder::errorString() const
+{
+    QMutexLocker locker(&mutex);
+    return error_string;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Queue one raw frame; never blocks on disk
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void SessionRecorder::write(uint16_t device, int64_t timestamp, const uint8_t *frame, int len)
+{
+    const int max_records = 16;
+    const int chunk = sizeof(SessionFile::Record::frame);
+    SessionFile::Record records[max_records];
+    int count = 0;
+
+    if (!isRecording())
+        return;
+
+    while (len > 0 && count < max_records) {       // split long frames over continuation records
+        int n = len < chunk ? len : chunk;
+        SessionFile::Record &record = records[count++];
+        memset(&record, 0, sizeof(record));
+        record.timestamp = timestamp;
+        record.device = device;
+        record.length = (uint8_t)n;
+        memcpy(record.frame, frame, n);
+        frame += n;
+        len -= n;
+        record.flags = len > 0 ? SessionFile::RecordContinued : 0;
+    }
+
+    QMutexLocker locker(&mutex);
+    if (!recording.load(std::memory_order_relaxed))
+        return;
+    if (front.size() >= MaxPendingRecords * (int)sizeof(SessionFile::Record)) {    // disk is hopelessly behind
+        dropped_records.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+    front.append((const char *)records, count * (int)sizeof(SessionFile::Record));
+    if (front.size() >= BufferRecords * (int)sizeof(SessionFile::Record))
+        buffer_ready.wakeOne();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Writer thread: swap buffers and write the filled one in one go
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void SessionRecorder::run()
+{
+    QMutexLocker locker(&mutex);
+
+    forever {
+        if (!stopping && front.size() < BufferRecords * (int)sizeof(SessionFile::Record))
+            buffer_ready.wait(&mutex, FlushInterval);
+
+        front.swap(back);
+        bool done = stopping;
+        locker.unlock();
+
+        if (!back.isEmpty()) {
+            qint64 written = file.write(back);
+            file.flush();
+            if (written != back.size()) {
+                locker.relock();
+                error_string = file.errorString();
+                locker.unlock();
+                dropped_records.fetch_add((back.size() - qMax<qint64>(written, 0)) / sizeof(SessionFile::Record), std::memory_order_relaxed);
+            }
+            records_written.fetch_add(qMax<qint64>(written, 0) / sizeof(SessionFile::Record), std::memory_order_relaxed);
+            back.resize(0);             // keeps the allocation for the next swap
+        }
+
+        locker.relock();
+        if (done && front.isEmpty())
+            break;
+    }
+}
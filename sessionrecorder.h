@@ -0,0 +1,62 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#include "sessionfile.h"
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Append-only recorder for every decoded frame.
+//
+// write() only copies the frame into an in-memory buffer and returns, it
+// may be called from any number of ingestion threads. A background thread
+// swaps the filled buffer with an empty one and writes it to disk in one
+// large write, so no caller ever waits for the disk.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class SessionRecorder : public QThread
+{
+    Q_OBJECT
+
+public:
+    static const int BufferRecords = 32768;             // 1 MiB per buffer
+    static const int MaxPendingRecords = 64 * BufferRecords;
+    static const int FlushInterval = 250;               // ms
+
+    explicit SessionRecorder(QObject *parent = nullptr);
+    ~SessionRecorder();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isRecording() const { return recording.load(std::memory_order_acquire); }
+    QString errorString() const;
+
+    void write(uint16_t device, int64_t timestamp, const uint8_t *frame, int len);
+
+    uint64_t recordsWritten() const { return records_written.load(std::memory_order_relaxed); }
+    uint64_t droppedRecords() const { return dropped_records.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    QFile file;
+    QString error_string;
+
+    mutable QMutex mutex;
+    QWaitCondition buffer_ready;
+    QByteArray front;               // being filled by write()
+    QByteArray back;                // being written by run()
+    bool stopping = false;
+
+    std::atomic<bool> recording{false};
+    std::atomic<uint64_t> records_written{0};
+    std::atomic<uint64_t> dropped_records{0};
+};
+
+#endif // SESSIONRECORDER_H
@@ -0,0 +1,180 @@
+#include "devicesimulator.h"
+
+#include <QHostAddress>
+
+#include <QtMath>
+
+static const double Gravity = 9.81;
+
+static int16_t toRaw16(double value)
+{
+    double raw = round(value * 1.0e4);
+    if (raw > 32767.0)
+        raw = 32767.0;
+    if (raw < -32768.0)
+        raw = -32768.0;
+    return (int16_t)raw;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Constructor
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+DeviceSimulator::DeviceSimulator(int index, const SimulatorConfig &config, QObject *parent) :
+    QObject(parent),
+    index(index),
+    config(config),
+    random((quint32)(index + 1))
+{
+    phase_offset = index * 0.7;
+    connect(&server, &QTcpServer::newConnection, this, &DeviceSimulator::acceptClient);
+    connect(&timer, &QTimer::timeout, this, &DeviceSimulator::generate);
+    timer.setTimerType(Qt::PreciseTimer);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Start serving on localhost
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+bool DeviceSimulator::listen()
+{
+    if (!server.listen(QHostAddress::LocalHost, port()))
+        return false;
+    clock.start();
+    timer.start(1);
+    return true;
+}
+
+void DeviceSimulator::acceptClient()
+{
+    while (server.hasPendingConnections()) {
+        QTcpSocket *client = server.nextPendingConnection();
+        client->setSocketOption(QAbstractSocket::LowDelayOption, 1);   // keep fragments apart on the wire
+        connect(client, &QTcpSocket::disconnected, this, &DeviceSimulator::dropClient);
+        connect(client, &QTcpSocket::readyRead, this, &DeviceSimulator::readClient);
+        clients.append(client);
+        client_versions.insert(client, 1);
+    }
+}
+
+void DeviceSimulator::dropClient()
+{
+    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
+    clients.removeAll(client);
+    client_versions.remove(client);
+    client->deleteLater();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The only thing a client sends is the protocol hello
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DeviceSimulator::readClient()
+{
+    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
+    if (client->bytesAvailable() < FrameDecoder::HelloSize)
+        return;
+
+    QByteArray data = client->readAll();
+    const char prefix[] = { (char)FrameDecoder::Header1, (char)FrameDecoder::Header2, (char)FrameDecoder::HelloType };
+    int pos = data.lastIndexOf(QByteArray(prefix, sizeof(prefix)));
+    if (pos < 0 || pos + FrameDecoder::HelloSize > data.size())
+        return;
+
+    const uint8_t *hello = (const uint8_t *)data.constData() + pos;
+    if (hello[FrameDecoder::HelloSize - 1] != FrameDecoder::calculateChecksum(hello + 1, FrameDecoder::HelloSize - 1))
+        return;
+    client_versions[client] = qBound(1, (int)hello[3], config.protocol);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Produce every sample that is due by now
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DeviceSimulator::generate()
+{
+    quint64 due = (quint64)(clock.nsecsElapsed() / 1.0e9 * config.rate);
+    uint8_t frame[FrameEncoder::MaxFrameSize];
+
+    while (samples_generated < due) {
+        RawSample sample = sampleAt(samples_generated / config.rate);
+        bool corrupt = config.corruption > 0.0 && random.generateDouble() < config.corruption;
+        if (batch_count == 0)
+            batch_tick = (uint32_t)(samples_generated * 1.0e6 / config.rate);
+        samples_generated++;
+        bool emitted = config.protocol < 3;     // a frame for the highest version ends with this sample
+
+        for (int version = 1; version <= qMin(config.protocol, 2); version++) {
+            int len = FrameEncoder::encode(sample, frame, version);
+            if (corrupt)
+                frame[random.bounded(len)] ^= (uint8_t)(1 + random.bounded(255));
+            pending[version].append((const char *)frame, len);
+        }
+        if (config.protocol >= 3) {     // v3 clients get samples_per_frame samples under one header
+            batch[batch_count++] = sample;
+            batch_corrupt = batch_corrupt || corrupt;
+            if (batch_count == config.samples_per_frame) {
+                uint16_t period = (uint16_t)qMin(1.0e6 / config.rate, 65535.0);
+                int len = FrameEncoder::encodeBatch(batch, batch_count, sequence++, batch_tick, period, frame);
+                if (batch_corrupt)
+                    frame[random.bounded(len)] ^= (uint8_t)(1 + random.bounded(255));
+                if (config.drop == 0.0 || random.generateDouble() >= config.drop)    // a dropped frame still uses up its sequence number
+                    pending[3].append((const char *)frame, len);
+                if (config.duplicate > 0.0 && random.generateDouble() < config.duplicate)
+                    pending[3].append((const char *)frame, len);
+                batch_count = 0;
+                batch_corrupt = false;
+                emitted = true;
+            }
+        }
+        if (emitted && ++pending_frames >= config.burst) {
+            send();
+            for (int version = 1; version <= config.protocol; version++)
+                pending[version].clear();
+            pending_frames = 0;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Synthetic compression at time t: raised cosine displacement with the
+// matching velocity and acceleration, plus gravity on the z axis
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+RawSample DeviceSimulator::sampleAt(double t) const
+{
+    double f = config.compressions / 60.0;
+    double phase = 2.0 * M_PI * f * t + phase_offset;
+    double w = 2.0 * M_PI * f;
+
+    double displacement = config.depth * (1.0 - cos(phase)) / 2.0;
+    double velocity = config.depth * w / 2.0 * sin(phase);
+    double acceleration = config.depth * w * w / 2.0 * cos(phase) / Gravity;
+
+    // compressions completed within the last second
+    int cycles_now = (int)floor(phase / (2.0 * M_PI));
+    int cycles_before = (int)floor((phase - w) / (2.0 * M_PI));
+
+    RawSample sample;
+    sample.x = toRaw16(0.01 * sin(3.1 * t));
+    sample.y = toRaw16(0.01 * cos(2.3 * t));
+    sample.z = toRaw16(1.0 + acceleration);
+    sample.displacement = (uint16_t)toRaw16(displacement);
+    sample.velocity = toRaw16(velocity);
+    sample.tap_count = (uint8_t)qBound(0, cycles_now - cycles_before, 255);
+    sample.cpr_good = config.compressions >= 100.0 && config.compressions <= 120.0 && config.depth >= 0.05;
+    return sample;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Write the burst to every client in its version, fragmented if requested
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+void DeviceSimulator::send()
+{
+    foreach (QTcpSocket *client, clients) {
+        const QByteArray &data = pending[client_versions.value(client, 1)];
+        int piece = config.fragment > 0 ? config.fragment : data.size();
+        for (int offset = 0; offset < data.size(); offset += piece) {
+            client->write(data.constData() + offset, qMin(piece, data.size() - offset));
+            if (config.fragment > 0)
+                client->flush();
+        }
+    }
+    if (!clients.isEmpty())
+        frames_sent += pending_frames;
+}
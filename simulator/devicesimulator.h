@@ -0,0 +1,83 @@
+#ifndef DEVICESIMULATOR_H
+#define DEVICESIMULATOR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "frameencoder.h"
+
+// Load and waveform settings shared by all simulated manikins
+struct SimulatorConfig {
+    int devices = 1;
+    quint16 base_port = 9000;       // device n listens on base_port + n
+    double rate = 100.0;            // samples per second
+    int burst = 1;                  // frames sent per write, of the highest protocol version
+    int fragment = 0;               // split writes into pieces of at most this many bytes, 0 = off
+    double corruption = 0.0;        // probability of a corrupted byte per frame
+    double compressions = 110.0;    // compressions per minute
+    double depth = 0.055;           // compression depth in meters
+    int protocol = 1;               // highest frame protocol version a client can ask for
+    int samples_per_frame = 10;     // v3: samples packed into one frame
+    double drop = 0.0;              // v3: probability of a frame lost before it is sent
+    double duplicate = 0.0;         // v3: probability of a frame sent twice
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// One simulated manikin on a localhost port.
+//
+// Generates a synthetic compression waveform at the configured sample
+// rate and serves it to every connected client in the 0xAA 0x86 frame
+// format, optionally in bursts, fragmented or with corrupted bytes.
+// Clients get v1 frames until they send a hello asking for a newer
+// version, then the highest one both sides know.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+class DeviceSimulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    DeviceSimulator(int index, const SimulatorConfig &config, QObject *parent = nullptr);
+
+    bool listen();
+    quint16 port() const { return (quint16)(config.base_port + index); }
+    quint64 framesSent() const { return frames_sent; }
+    int clientCount() const { return clients.size(); }
+
+private slots:
+    void acceptClient();
+    void dropClient();
+    void readClient();
+    void generate();
+
+private:
+    RawSample sampleAt(double t) const;
+    void send();
+
+    int index;
+    SimulatorConfig config;
+    QTcpServer server;
+    QList<QTcpSocket*> clients;
+    QHash<QTcpSocket*, int> client_versions;
+    QTimer timer;
+    QElapsedTimer clock;
+    QRandomGenerator random;
+
+    quint64 samples_generated = 0;
+    quint64 frames_sent = 0;
+    QByteArray pending[FrameDecoder::MaxVersion + 1];   // frames of the current burst, per protocol version
+    int pending_frames = 0;         // frames of the highest version in the current burst
+    RawSample batch[FrameDecoder::MaxSamplesPerFrame];  // samples of the next v3 frame
+    int batch_count = 0;
+    bool batch_corrupt = false;
+    uint32_t batch_tick = 0;        // us since start of the first sample in batch
+    uint16_t sequence = 0;          // of v3 frames
+    double phase_offset;            // so that devices are not in lockstep
+};
+
+#endif // DEVICESIMULATOR_H
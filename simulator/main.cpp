@@ -0,0 +1,87 @@
+#include "devicesimulator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <stdio.h>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Local stand-in for one or more manikins, for load and latency tests
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CPR manikin simulator");
+    parser.addHelpOption();
+
+    QCommandLineOption devicesOption("devices", "Number of simulated manikins.", "count", "1");
+    QCommandLineOption portOption("port", "Port of the first manikin; the others follow.", "port", "9000");
+    QCommandLineOption rateOption("rate", "Samples per second per manikin.", "hz", "100");
+    QCommandLineOption burstOption("burst", "Frames sent per write; protocol v3 frames with --protocol 3.", "frames", "1");
+    QCommandLineOption fragmentOption("fragment", "Split writes into pieces of at most this many bytes.", "bytes", "0");
+    QCommandLineOption corruptionOption("corrupt", "Probability of a corrupted frame.", "probability", "0");
+    QCommandLineOption compressionsOption("cpm", "Compressions per minute.", "rate", "110");
+    QCommandLineOption depthOption("depth", "Compression depth in meters.", "meters", "0.055");
+    QCommandLineOption protocolOption("protocol", "Highest frame protocol version the firmware speaks; clients get v1 unless they ask for more.", "version", "1");
+    QCommandLineOption samplesOption("samples-per-frame", "Samples packed into one protocol v3 frame.", "count", "10");
+    QCommandLineOption dropOption("drop", "Probability of a protocol v3 frame lost before it is sent.", "probability", "0");
+    QCommandLineOption duplicateOption("duplicate", "Probability of a protocol v3 frame sent twice.", "probability", "0");
+    parser.addOption(devicesOption);
+    parser.addOption(portOption);
+    parser.addOption(rateOption);
+    parser.addOption(burstOption);
+    parser.addOption(fragmentOption);
+    parser.addOption(corruptionOption);
+    parser.addOption(compressionsOption);
+    parser.addOption(depthOption);
+    parser.addOption(protocolOption);
+    parser.addOption(samplesOption);
+    parser.addOption(dropOption);
+    parser.addOption(duplicateOption);
+    parser.process(a);
+
+    SimulatorConfig config;
+    config.devices = qMax(1, parser.value(devicesOption).toInt());
+    config.base_port = parser.value(portOption).toUShort();
+    config.rate = qMax(1.0, parser.value(rateOption).toDouble());
+    config.burst = qMax(1, parser.value(burstOption).toInt());
+    config.fragment = qMax(0, parser.value(fragmentOption).toInt());
+    config.corruption = qBound(0.0, parser.value(corruptionOption).toDouble(), 1.0);
+    config.compressions = qMax(1.0, parser.value(compressionsOption).toDouble());
+    config.depth = qMax(0.0, parser.value(depthOption).toDouble());
+    config.protocol = qBound(1, parser.value(protocolOption).toInt(), (int)FrameDecoder::MaxVersion);
+    config.samples_per_frame = qBound(1, parser.value(samplesOption).toInt(), (int)FrameDecoder::MaxSamplesPerFrame);
+    config.drop = qBound(0.0, parser.value(dropOption).toDouble(), 1.0);
+    config.duplicate = qBound(0.0, parser.value(duplicateOption).toDouble(), 1.0);
+
+    QList<DeviceSimulator*> devices;
+    for (int i = 0; i < config.devices; i++) {
+        DeviceSimulator *device = new DeviceSimulator(i, config, &a);
+        if (!device->listen()) {
+            fprintf(stderr, "Could not listen on port %u\n", device->port());
+            return EXIT_FAILURE;
+        }
+        devices.append(device);
+    }
+    printf("Simulating %d manikin(s) on localhost:%u-%u at %.0f Hz\n",
+           config.devices, config.base_port, config.base_port + config.devices - 1, config.rate);
+    fflush(stdout);
+
+    QTimer stats;
+    QObject::connect(&stats, &QTimer::timeout, [&devices]() {
+        quint64 frames = 0;
+        int clients = 0;
+        foreach (DeviceSimulator *device, devices) {
+            frames += device->framesSent();
+            clients += device->clientCount();
+        }
+        printf("clients %d  frames sent %llu\n", clients, (unsigned long long)frames);
+        fflush(stdout);
+    });
+    stats.start(5000);
+
+    return a.exec();
+}
@@ -0,0 +1,28 @@
+QT       += core network
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = cprsimulator
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../crc32c.cpp \
+    ../framedecoder.cpp \
+    ../frameencoder.cpp \
+    devicesimulator.cpp \
+    main.cpp
+
+HEADERS += \
+    ../crc32c.h \
+    ../framedecoder.h \
+    ../frameencoder.h \
+    devicesimulator.h
+
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
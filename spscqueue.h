@@ -0,0 +1,71 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Bounded lock-free single-producer/single-consumer ring.
+//
+// push() may only be called from one thread and pop() from one other
+// thread. When the ring is full the new item is dropped and counted in
+// overflowCount() - the producer never waits for the consumer.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(uint32_t capacity)
+    {
+        uint32_t size = 2;
+        while (size < capacity)         // round up to a power of two so indices can be masked
+            size <<= 1;
+        items.resize(size);
+        mask = size - 1;
+    }
+
+    bool push(const T &item)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) {
+            overflow.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T *item)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        *item = items[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t capacity() const { return mask + 1; }
+    uint32_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+    uint64_t overflowCount() const { return overflow.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> items;
+    uint32_t mask;
+
+    // keep producer and consumer indices on separate cache lines. Padded
+    // rather than alignas(64): the queues live in heap objects, and before
+    // C++17 operator new does not honour extended alignment
+    static const int CacheLine = 64;
+    char pad0[CacheLine];
+    std::atomic<uint32_t> head{0};
+    char pad1[CacheLine - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint32_t> tail{0};
+    char pad2[CacheLine - sizeof(std::atomic<uint32_t>)];
+    std::atomic<uint64_t> overflow{0};
+    char pad3[CacheLine - sizeof(std::atomic<uint64_t>)];
+};
+
+#endif // SPSCQUEUE_H
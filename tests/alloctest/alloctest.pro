@@ -0,0 +1,57 @@
+QT       += core gui network printsupport widgets
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = alloctest
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../batchdecoder.cpp \
+    ../../clockestimator.cpp \
+    ../../compressiondetector.cpp \
+    ../../connectionmanager.cpp \
+    ../../cprmetrics.cpp \
+    ../../crc32c.cpp \
+    ../../devicepipeline.cpp \
+    ../../framedecoder.cpp \
+    ../../frameencoder.cpp \
+    ../../ingestionworker.cpp \
+    ../../jitterbuffer.cpp \
+    ../../latencyhistogram.cpp \
+    ../../latencymonitor.cpp \
+    ../../plotbatch.cpp \
+    ../../processingpool.cpp \
+    ../../qcustomplot.cpp \
+    ../../rawinputmodel.cpp \
+    ../../replaysource.cpp \
+    ../../sessionrecorder.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../batchdecoder.h \
+    ../../clockestimator.h \
+    ../../compressiondetector.h \
+    ../../connectionmanager.h \
+    ../../cprmetrics.h \
+    ../../cprsample.h \
+    ../../crc32c.h \
+    ../../devicepipeline.h \
+    ../../framedecoder.h \
+    ../../frameencoder.h \
+    ../../ingestionworker.h \
+    ../../jitterbuffer.h \
+    ../../latencyhistogram.h \
+    ../../latencymonitor.h \
+    ../../monotonicclock.h \
+    ../../plotbatch.h \
+    ../../processingpool.h \
+    ../../qcustomplot.h \
+    ../../rawinputmodel.h \
+    ../../replaysource.h \
+    ../../sessionfile.h \
+    ../../sessionrecorder.h \
+    ../../spscqueue.h
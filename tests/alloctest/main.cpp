@@ -0,0 +1,328 @@
+#include "devicepipeline.h"
+#include "frameencoder.h"
+#include "ingestionworker.h"
+#include "jitterbuffer.h"
+#include "latencymonitor.h"
+#include "monotonicclock.h"
+#include "plotbatch.h"
+#include "processingpool.h"
+#include "qcustomplot.h"
+#include "rawinputmodel.h"
+
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+
+#include <atomic>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const int StreamSamples = 6000;          // a minute at 100 Hz
+static const int WriteSize = 100;               // bytes per write on the manikin side, frames end up split
+static const int Rounds = 4;                    // after the warm-up one
+static const int SamplesPerFrame = 10;          // v3, as the simulator sends them
+static const int DeviceCount = FrameDecoder::MaxVersion;   // one per protocol version, the last one plotted through a jitter buffer
+static const int64_t RoundTimeout = 30000000000LL;         // ns
+
+static std::atomic<bool> counting{false};
+static std::atomic<uint64_t> allocations{0};
+static thread_local bool manikin_side = false;  // the test playing the manikins, not counted
+
+#ifdef __GLIBC__
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Every heap allocation in the process goes through here: operator new
+// ends up in malloc, and so do QByteArray, QVector and QString. glibc
+// lets a program replace malloc as long as free and the aligned variants
+// come along; they all forward to glibc's own allocator.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *p);
+}
+
+static inline void countAllocation()
+{
+    if (counting.load(std::memory_order_relaxed) && !manikin_side)
+        allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" void *malloc(size_t size) noexcept
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_realloc(p, size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **p, size_t alignment, size_t size) noexcept
+{
+    countAllocation();
+    *p = __libc_memalign(alignment, size);
+    return *p ? 0 : ENOMEM;
+}
+
+extern "C" void free(void *p) noexcept
+{
+    __libc_free(p);
+}
+#endif
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The simulator's waveform: 110 compressions per minute, 55 mm deep
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static RawSample sampleAt(double t)
+{
+    double phase = 2.0 * M_PI * 110.0 / 60.0 * t;
+    RawSample sample;
+    sample.x = (int16_t)(100.0 * sin(3.1 * t));
+    sample.y = (int16_t)(100.0 * cos(2.3 * t));
+    sample.z = (int16_t)(1.0e4 + 500.0 * cos(phase));
+    sample.displacement = (uint16_t)(550.0 * (1.0 - cos(phase)) / 2.0);
+    sample.velocity = (int16_t)(300.0 * sin(phase));
+    sample.tap_count = 0;
+    sample.cpr_good = 1;
+    return sample;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// StreamSamples samples from sample number first on; v3 sequence numbers
+// and ticks carry on from the round before, so no round starts with a gap
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static std::vector<uint8_t> makeStream(int version, int first)
+{
+    std::vector<uint8_t> stream(StreamSamples * FrameEncoder::MaxFrameSize);
+    RawSample batch[SamplesPerFrame];
+    size_t size = 0;
+    for (int i = first; i < first + StreamSamples; i++) {
+        RawSample sample = sampleAt(i / 100.0);
+        if (version < 3) {
+            size += FrameEncoder::encode(sample, stream.data() + size, version);
+            continue;
+        }
+        batch[i % SamplesPerFrame] = sample;
+        if ((i + 1) % SamplesPerFrame == 0) {
+            uint32_t tick = (uint32_t)(i + 1 - SamplesPerFrame) * 10000;
+            size += FrameEncoder::encodeBatch(batch, SamplesPerFrame, (uint16_t)(i / SamplesPerFrame), tick, 10000, stream.data() + size);
+        }
+    }
+    stream.resize(size);
+    return stream;
+}
+
+// One manikin on a local port and everything the application runs for it
+struct TestDevice {
+    int version;
+    QTcpServer server;
+    QTcpSocket *manikin = nullptr;
+    DevicePipeline *pipeline = nullptr;
+    IngestionWorker *worker = nullptr;
+    JitterBuffer jitter;
+    QCPGraphDataContainer graphs[PlotBatch::GraphCount];
+    uint64_t frames = 0;                // sent so far
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// The manikin sends one round of its stream, write by write
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void send(TestDevice *device, int round)
+{
+    manikin_side = true;
+    std::vector<uint8_t> stream = makeStream(device->version, round * StreamSamples);
+    for (size_t offset = 0; offset < stream.size(); offset += WriteSize) {
+        device->manikin->write((const char *)stream.data() + offset, (qint64)qMin(stream.size() - offset, (size_t)WriteSize));
+        device->manikin->flush();
+    }
+    device->frames += device->version < 3 ? StreamSamples : StreamSamples / SamplesPerFrame;
+    manikin_side = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Wait until every frame sent is decoded, without draining; false on a
+// timeout
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static bool waitDecoded(TestDevice *devices)
+{
+    int64_t started = monotonicNanoseconds();
+    manikin_side = true;
+    bool done = false;
+    while (!done && monotonicNanoseconds() - started < RoundTimeout) {
+        QCoreApplication::processEvents();
+        QThread::msleep(1);
+        done = true;
+        for (int i = 0; i < DeviceCount; i++)
+            done = done && devices[i].pipeline->decodedFrames() == devices[i].frames && devices[i].pipeline->isIdle();
+    }
+    manikin_side = false;
+    return done;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Plot updates as MainWindow::realtimeDataSlot() makes them, until every
+// frame sent is decoded and drained. Returns the points added to the
+// graphs of the devices without jitter buffer, -1 on a timeout.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static int64_t plot(TestDevice *devices, PlotBatch *batch, LatencyMonitor *latency)
+{
+    int64_t started = monotonicNanoseconds();
+    int64_t points = 0;
+
+    bool done = false;
+    while (!done) {
+        done = true;
+        for (int i = 0; i < DeviceCount; i++) {
+            TestDevice &device = devices[i];
+            bool jittered = i == DeviceCount - 1;
+            bool idle = device.pipeline->decodedFrames() == device.frames && device.pipeline->isIdle();   // before draining, so no sample comes after
+            batch->drain(i + 1, device.pipeline, jittered ? &device.jitter : nullptr);
+            if (!batch->isEmpty()) {
+                latency->batchAdded(monotonicNanoseconds());
+                for (int graph = 0; graph < PlotBatch::GraphCount; graph++)
+                    device.graphs[graph].add(batch->points(graph), true);
+            }
+            if (!jittered)
+                points += batch->points(0).size();
+            done = done && idle;
+        }
+        int64_t shown = monotonicNanoseconds();
+        latency->batchShown(shown);
+        latency->rollWindow(shown);
+
+        manikin_side = true;
+        QCoreApplication::processEvents();      // whatever the manikins could not hand to the kernel yet
+        manikin_side = false;
+
+        if (shown - started > RoundTimeout)
+            return -1;
+        QThread::msleep(1);
+    }
+    return points;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Frames of every protocol version read off TCP sockets by
+// IngestionWorkers, decoded by DevicePipelines on the pool and drained
+// into the graphs' data as the plotting thread does must not allocate
+// once warmed up
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int main(int argc, char *argv[])
+{
+#ifndef __GLIBC__
+    printf("SKIP: counting malloc needs glibc\n");
+    return EXIT_SUCCESS;
+#endif
+    qputenv("QT_NO_GLIB", "1");         // the plain Unix event dispatcher
+    QCoreApplication app(argc, argv);
+
+    ProcessingPool pool(2);
+    QThread ingestion_thread;
+    int64_t start_time = monotonicNanoseconds();
+    LatencyMonitor latency;
+    RawInputModel raw_input;
+    PlotBatch batch(start_time, &latency, &raw_input);
+    TestDevice devices[DeviceCount];
+
+    for (int i = 0; i < DeviceCount; i++) {
+        TestDevice &device = devices[i];
+        device.version = i + 1;
+        if (!device.server.listen(QHostAddress::LocalHost)) {
+            fprintf(stderr, "FAIL: cannot listen: %s\n", qPrintable(device.server.errorString()));
+            return EXIT_FAILURE;
+        }
+        device.pipeline = new DevicePipeline(&pool, start_time);
+        device.worker = new IngestionWorker(QHostAddress::LocalHost, device.server.serverPort(), device.pipeline);
+        device.worker->setProtocol(device.version);
+        device.worker->moveToThread(&ingestion_thread);
+        QObject::connect(&ingestion_thread, &QThread::started, device.worker, &IngestionWorker::start);
+        device.jitter.setDelay(20000000);
+        device.jitter.setPeriod(10000000);
+        for (int graph = 0; graph < PlotBatch::GraphCount; graph++)
+            device.graphs[graph].setRingCapacity(1 << 14);     // wraps during the counted rounds
+    }
+    ingestion_thread.start();
+    for (int i = 0; i < DeviceCount; i++) {
+        if (!devices[i].server.waitForNewConnection(5000)) {
+            fprintf(stderr, "FAIL: device %d did not connect\n", i + 1);
+            return EXIT_FAILURE;
+        }
+        devices[i].manikin = devices[i].server.nextPendingConnection();
+        devices[i].manikin->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    }
+
+    // the warm-up round is drained in one go, so the plot batch grows to
+    // more than any later update needs
+    for (int i = 0; i < DeviceCount; i++)
+        send(&devices[i], 0);
+    int64_t warm_up = waitDecoded(devices) ? plot(devices, &batch, &latency) : -1;
+
+    counting.store(true);
+    int64_t points = 0;
+    for (int round = 1; round <= Rounds && warm_up >= 0 && points >= 0; round++) {
+        for (int i = 0; i < DeviceCount; i++)
+            send(&devices[i], round);
+        int64_t plotted = plot(devices, &batch, &latency);
+        points = plotted < 0 ? -1 : points + plotted;
+    }
+    counting.store(false);
+
+    uint64_t frames = 0;
+    for (int i = 0; i < DeviceCount; i++)
+        frames += devices[i].pipeline->decodedFrames();
+    printf("warm-up %lld points, then %lld points: %llu allocations (%.4f per frame)\n",
+           (long long)warm_up, (long long)points, (unsigned long long)allocations.load(),
+           frames > 0 ? (double)allocations.load() / frames : 0.0);
+
+    for (int i = 0; i < DeviceCount; i++)
+        QMetaObject::invokeMethod(devices[i].worker, "stop", Qt::BlockingQueuedConnection);
+    ingestion_thread.quit();
+    ingestion_thread.wait();
+    pool.stop();                        // before the pipelines go away
+    for (int i = 0; i < DeviceCount; i++) {
+        delete devices[i].worker;
+        delete devices[i].pipeline;
+    }
+
+    if (warm_up < 0 || points < 0) {
+        fprintf(stderr, "FAIL: timed out waiting for the samples\n");
+        return EXIT_FAILURE;
+    }
+    if (points != (int64_t)Rounds * (DeviceCount - 1) * StreamSamples) {
+        fprintf(stderr, "FAIL: expected %d points per device and round\n", StreamSamples);
+        return EXIT_FAILURE;
+    }
+    if (allocations.load() != 0) {
+        fprintf(stderr, "FAIL: the ingestion path allocates after warm-up\n");
+        return EXIT_FAILURE;
+    }
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
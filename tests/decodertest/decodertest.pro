@@ -0,0 +1,23 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = decodertest
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../crc32c.cpp \
+    ../../framedecoder.cpp \
+    ../../frameencoder.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../cprsample.h \
+    ../../crc32c.h \
+    ../../framedecoder.h \
+    ../../frameencoder.h
@@ -0,0 +1,158 @@
+#include "framedecoder.h"
+#include "frameencoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static const int StreamSamples = 200;
+static const int ReadSize = 7;                  // bytes per simulated socket read, frames end up split
+static const int SamplesPerFrame = 4;           // v3
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Samples whose x puts a v2 or v3 version byte where a v1 frame has its
+// first payload byte, and a plausible v3 sample count right after it.
+// Not the last one: with no header after it, such a v1 frame could still
+// be the start of a longer one and is rightly held back.
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static RawSample sampleAt(int i)
+{
+    RawSample sample;
+    sample.x = (int16_t)((1 + i % FrameDecoder::MaxSamplesPerFrame) << 8 | (i < StreamSamples - 1 ? 2 + i % 2 : 0x10));
+    sample.y = (int16_t)(i * 7);
+    sample.z = (int16_t)(10000 - i);
+    sample.displacement = (uint16_t)(i % 600);
+    sample.velocity = (int16_t)(i - 100);
+    sample.tap_count = 0;
+    sample.cpr_good = 1;
+    return sample;
+}
+
+static std::vector<uint8_t> makeStream(int version)
+{
+    std::vector<uint8_t> stream(StreamSamples * FrameEncoder::MaxFrameSize);
+    RawSample batch[SamplesPerFrame];
+    size_t size = 0;
+    for (int i = 0; i < StreamSamples; i++) {
+        if (version < 3) {
+            size += FrameEncoder::encode(sampleAt(i), stream.data() + size, version);
+            continue;
+        }
+        batch[i % SamplesPerFrame] = sampleAt(i);
+        if ((i + 1) % SamplesPerFrame == 0)
+            size += FrameEncoder::encodeBatch(batch, SamplesPerFrame, (uint16_t)(i / SamplesPerFrame),
+                                              (uint32_t)(i + 1 - SamplesPerFrame) * 10000, 10000, stream.data() + size);
+    }
+    stream.resize(size);
+    return stream;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Feed a stream read by read; returns the samples decoded, which must
+// be the ones sampleAt() made, in order
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static int decode(FrameDecoder *decoder, const std::vector<uint8_t> &stream, int read_size)
+{
+    uint8_t payloads[FrameDecoder::MaxSamplesPerFrame * FrameDecoder::PayloadSize];
+    int decoded = 0;
+    bool in_order = true;
+
+    for (size_t offset = 0; offset < stream.size(); ) {
+        int len = (int)(stream.size() - offset < (size_t)read_size ? stream.size() - offset : read_size);
+        offset += decoder->feed((const char *)stream.data() + offset, len);
+        int count;
+        while ((count = decoder->nextPayloads(payloads, FrameDecoder::MaxSamplesPerFrame)) > 0) {
+            for (int i = 0; i < count; i++) {
+                const uint8_t *payload = payloads + i * FrameDecoder::PayloadSize;
+                int16_t x = (int16_t)(payload[0] | (payload[1] << 8));
+                int16_t y = (int16_t)(payload[2] | (payload[3] << 8));
+                in_order = in_order && x == sampleAt(decoded).x && y == sampleAt(decoded).y;
+                decoded++;
+            }
+        }
+    }
+    return in_order ? decoded : -1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Reconnecting from CRC checked firmware to v1 firmware: every v1 frame
+// decodes, also those whose first payload byte looks like a version
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void testReconnectToV1(int version)
+{
+    FrameDecoder decoder;
+    char what[80];
+
+    int before = decode(&decoder, makeStream(version), ReadSize);
+    snprintf(what, sizeof(what), "v%d session decodes", version);
+    check(before == StreamSamples && decoder.version() == version, what);
+
+    decoder.discardBuffered();
+    uint64_t errors = decoder.checksumErrors();
+    int after = decode(&decoder, makeStream(1), ReadSize);
+    snprintf(what, sizeof(what), "v1 stream after a v%d session decodes", version);
+    check(after == StreamSamples && decoder.version() == 1 && decoder.checksumErrors() == errors, what);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Reconnecting to the same v3 firmware, one byte per read: the first
+// frame waits for its CRC instead of being split up as v1, even where
+// its first 15 bytes pass the XOR check and the 16th is a header byte
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void testReconnectToV3()
+{
+    uint8_t frame[FrameEncoder::MaxFrameSize];
+    RawSample batch[SamplesPerFrame];
+    int size = 0;
+    srand(3);
+    for (int sequence = 0; ; sequence++) {
+        for (int i = 0; i < SamplesPerFrame; i++)
+            batch[i] = sampleAt(rand() % StreamSamples);
+        batch[0].x = (int16_t)rand();
+        batch[0].y = (int16_t)rand();
+        size = FrameEncoder::encodeBatch(batch, SamplesPerFrame, (uint16_t)sequence, 0, 10000, frame);
+        if (frame[FrameDecoder::WireFrameSize] == FrameDecoder::Header1
+            && frame[FrameDecoder::WireFrameSize - 1] == FrameDecoder::calculateChecksum(frame + 1, FrameDecoder::FrameSize))
+            break;
+    }
+
+    FrameDecoder decoder;
+    check(decode(&decoder, makeStream(3), ReadSize) == StreamSamples, "v3 session decodes");
+    decoder.discardBuffered();
+
+    uint8_t payloads[FrameDecoder::MaxSamplesPerFrame * FrameDecoder::PayloadSize];
+    int decoded = 0;
+    bool ticked = true;
+    for (int i = 0; i < size; i++) {
+        decoder.feed((const char *)frame + i, 1);
+        int count = decoder.nextPayloads(payloads, FrameDecoder::MaxSamplesPerFrame);
+        decoded += count;
+        ticked = ticked && (count == 0 || decoder.hasTicks());
+    }
+    check(decoded == SamplesPerFrame && ticked && decoder.version() == 3, "first v3 frame after a reconnect is not read as v1");
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Version detection across discardBuffered()
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int main()
+{
+    testReconnectToV1(2);
+    testReconnectToV1(3);
+    testReconnectToV3();
+
+    if (failures > 0)
+        return EXIT_FAILURE;
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = jittertest
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../batchdecoder.cpp \
+    ../../clockestimator.cpp \
+    ../../compressiondetector.cpp \
+    ../../cprmetrics.cpp \
+    ../../crc32c.cpp \
+    ../../devicepipeline.cpp \
+    ../../framedecoder.cpp \
+    ../../frameencoder.cpp \
+    ../../jitterbuffer.cpp \
+    ../../processingpool.cpp \
+    ../../sessionrecorder.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../batchdecoder.h \
+    ../../clockestimator.h \
+    ../../compressiondetector.h \
+    ../../cprmetrics.h \
+    ../../cprsample.h \
+    ../../crc32c.h \
+    ../../devicepipeline.h \
+    ../../framedecoder.h \
+    ../../frameencoder.h \
+    ../../jitterbuffer.h \
+    ../../monotonicclock.h \
+    ../../processingpool.h \
+    ../../sessionfile.h \
+    ../../sessionrecorder.h \
+    ../../spscqueue.h
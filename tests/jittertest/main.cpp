@@ -0,0 +1,104 @@
+#include "devicepipeline.h"
+#include "frameencoder.h"
+#include "jitterbuffer.h"
+#include "processingpool.h"
+
+#include <QThread>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int64_t Period = 10000000;         // ns, 100 Hz
+static const int64_t Delay = 100000000;         // ns
+static const int Seconds = 10;
+static const int64_t Start = 1000000000;        // ns, plot time of the first read
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Read n of the bursty network: 20 to 80 ms apart, 50 ms on average
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static int64_t readTime(int n)
+{
+    return Start + n * 50000000LL + (n % 4 == 1 ? 30000000 : n % 4 == 3 ? -30000000 : 0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// A 100 Hz v1 device read in bursts goes through DevicePipeline, which
+// spreads each burst, then through the JitterBuffer: every sample must
+// come out on the grid, in order, with none late and no gap in between
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int main()
+{
+    ProcessingPool pool(1);
+    DevicePipeline pipeline(&pool, Start);
+    JitterBuffer jitter;
+    jitter.setDelay(Delay);
+    jitter.setPeriod(Period);
+
+    DevicePipeline::Chunk chunk;
+    CprSample sample;
+    int sent = 0;
+    int64_t last_in = 0;
+    bool distinct = true;
+    int out = 0;
+    int64_t last_out = 0;
+    float last_displacement = -1.0f;
+    bool on_grid = true;
+    bool in_order = true;
+    bool no_gap = true;
+
+    for (int n = 1; readTime(n) < Start + Seconds * 1000000000LL; n++) {
+        int64_t now = readTime(n);
+
+        // every frame the device sent since the read before
+        chunk.len = 0;
+        while (Start + (sent + 1) * Period <= now) {
+            RawSample raw = {};
+            raw.z = 10000;
+            raw.displacement = (uint16_t)sent;
+            chunk.len += FrameEncoder::encode(raw, (uint8_t *)chunk.data + chunk.len, 1);
+            sent++;
+        }
+        chunk.received = chunk.read_at = now;
+        pipeline.submit(chunk);
+        while (!pipeline.isIdle())
+            QThread::yieldCurrentThread();
+
+        while (pipeline.samples().pop(&sample)) {
+            distinct = distinct && sample.timestamp > last_in;
+            last_in = sample.timestamp;
+            jitter.push(sample);
+        }
+        while (jitter.pull(now, &sample)) {
+            on_grid = on_grid && (out == 0 || sample.timestamp - last_out == Period);
+            in_order = in_order && sample.displacement >= last_displacement;
+            no_gap = no_gap && !sample.gap;
+            last_out = sample.timestamp;
+            last_displacement = sample.displacement;
+            out++;
+        }
+    }
+    pool.stop();
+
+    printf("%d samples sent in bursts, %d played out, %llu late\n", sent, out, (unsigned long long)jitter.lateSamples());
+    check(distinct, "the pipeline spreads every burst to distinct plot times");
+    check(on_grid && no_gap, "samples are played out on the grid without gaps");
+    check(in_order, "played out samples keep their order");
+    check(jitter.lateSamples() == 0, "no sample arrives after its time was played out");
+    check(out >= sent - (int)(2 * Delay / Period), "every sample but the delayed ones is played out");
+
+    if (failures > 0)
+        return EXIT_FAILURE;
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}
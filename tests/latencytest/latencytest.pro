@@ -0,0 +1,21 @@
+QT       += core
+QT       -= gui
+
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle
+
+TARGET = latencytest
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    ../../latencyhistogram.cpp \
+    ../../latencymonitor.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../cprsample.h \
+    ../../latencyhistogram.h \
+    ../../latencymonitor.h
@@ -0,0 +1,66 @@
+#include "latencymonitor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const int64_t Tick = 16000000;          // ns, one display frame
+static const int SamplesPerTick = 2;            // 100 Hz at 60 frames per second, roughly
+static const int HiddenTicks = 60 * 60;         // a minute minimized
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// One timer tick of MainWindow::realtimeDataSlot(): samples read a tick
+// ago are drained and added, then either shown or, with the window
+// hidden, dropped
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+static void tick(LatencyMonitor *latency, int64_t now, bool visible)
+{
+    CprSample sample = {};
+    for (int i = 0; i < SamplesPerTick; i++) {
+        sample.read_at = now - Tick;
+        sample.decoded_at = sample.read_at + 100000;
+        sample.enqueued_at = sample.decoded_at + 10000;
+        latency->sampleDrained(sample);
+    }
+    latency->batchAdded(now);
+    if (visible)
+        latency->batchShown(now + 2000000);
+    else
+        latency->batchDropped();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Samples drained while the window is hidden must not pile up waiting
+// for a replot, to be charged to the first one after it is shown again
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+int main()
+{
+    LatencyMonitor latency;
+    int64_t now = 1000000000;
+
+    for (int i = 0; i < 10; i++, now += Tick)
+        tick(&latency, now, true);
+    check(latency.pendingSamples() == 0, "a shown frame takes every pending sample");
+
+    int most = 0;
+    for (int i = 0; i < HiddenTicks; i++, now += Tick) {
+        tick(&latency, now, false);
+        if (latency.pendingSamples() > most)
+            most = latency.pendingSamples();
+    }
+    check(most == 0, "nothing stays pending while the window is hidden");
+
+    if (failures > 0)
+        return EXIT_FAILURE;
+    printf("PASS\n");
+    return EXIT_SUCCESS;
+}